@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BoardGenerator.h"
+#include "Whiteboard.h"
+#include "DrawCommand.h"
+#include "EraseCommand.h"
+#include "PartialEraseCommand.h"
+#include "CircleHitTest.h"
+
+// Times the core board operations on synthetic boards and prints the results as JSON.
+//
+//   WprogramBenchmark [--seed N] [--strokes N] [--circles N] [--brush SIZE]
+//                     [--distribution uniform|clustered] [--repetitions N] [--output FILE]
+
+namespace {
+
+    struct Options {
+        BoardConfig board;
+        int repetitions = 5;
+        int eraserPositions = 256;
+        std::string output;
+    };
+
+    struct Result {
+        std::string name;
+        // Operations per run, times are reported per operation
+        size_t operations;
+        std::vector<double> runNanoseconds;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: WprogramBenchmark [--seed N] [--strokes N] [--circles N] [--brush SIZE]\n"
+            "                         [--distribution uniform|clustered] [--repetitions N] [--output FILE]" << std::endl;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) return false;
+            std::string value = argv[++i];
+
+            if (arg == "--seed") options.board.seed = (unsigned int)std::strtoul(value.c_str(), nullptr, 10);
+            else if (arg == "--strokes") options.board.strokes = std::atoi(value.c_str());
+            else if (arg == "--circles") options.board.circlesPerStroke = std::atoi(value.c_str());
+            else if (arg == "--brush") options.board.brushSize = (float)std::atof(value.c_str());
+            else if (arg == "--distribution") {
+                if (!parseDistribution(value, options.board.distribution)) return false;
+            }
+            else if (arg == "--repetitions") options.repetitions = std::atoi(value.c_str());
+            else if (arg == "--output") options.output = value;
+            else return false;
+        }
+        return options.board.strokes > 0 && options.board.circlesPerStroke > 0
+            && options.board.brushSize > 0.0f && options.repetitions > 0;
+    }
+
+    // setup runs untimed before every repetition
+    Result measure(const std::string& name, size_t operations, int repetitions,
+        const std::function<void()>& setup, const std::function<void()>& run) {
+        Result result = { name, operations, {} };
+        for (int i = 0; i < repetitions; i++) {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            run();
+            auto end = std::chrono::steady_clock::now();
+            result.runNanoseconds.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        return result;
+    }
+
+    void fillBoard(Whiteboard& whiteboard, std::vector<SyntheticStroke>& strokes, float brushSize) {
+        std::vector<Stroke>& board = whiteboard.getStrokes();
+        board.clear();
+        for (SyntheticStroke& stroke : strokes)
+            board.emplace_back(stroke.circles, stroke.color, brushSize);
+        whiteboard.markBoardChanged();
+    }
+
+    void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+        const BoardConfig& board = options.board;
+        out << "{\n";
+#ifdef NDEBUG
+        out << "  \"build\": \"release\",\n";
+#else
+        out << "  \"build\": \"debug\",\n";
+#endif
+        out << "  \"config\": {\"seed\": " << board.seed
+            << ", \"strokes\": " << board.strokes
+            << ", \"circles_per_stroke\": " << board.circlesPerStroke
+            << ", \"brush_size\": " << board.brushSize
+            << ", \"distribution\": \"" << getDistributionName(board.distribution) << "\""
+            << ", \"repetitions\": " << options.repetitions << "},\n";
+        out << "  \"results\": [";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            std::vector<double> perOperation;
+            for (double run : result.runNanoseconds)
+                perOperation.push_back(run / std::max<size_t>(result.operations, 1));
+            std::sort(perOperation.begin(), perOperation.end());
+
+            double mean = 0.0;
+            for (double value : perOperation)
+                mean += value;
+            mean /= perOperation.size();
+
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\"name\": \"" << result.name << "\""
+                << ", \"operations\": " << result.operations
+                << ", \"median_ns\": " << perOperation[perOperation.size() / 2]
+                << ", \"min_ns\": " << perOperation.front()
+                << ", \"max_ns\": " << perOperation.back()
+                << ", \"mean_ns\": " << mean << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    const BoardConfig& config = options.board;
+    BoardGenerator generator(config.seed);
+    std::vector<SyntheticStroke> strokes = generator.generate(config);
+
+    // Eraser positions are drawn after the board so they depend on the same seed
+    std::vector<std::pair<float, float>> erasers;
+    for (int i = 0; i < options.eraserPositions; i++)
+        erasers.push_back({ generator.uniform(-3.5f, 3.5f), generator.uniform(-2.0f, 2.0f) });
+
+    std::vector<Result> results;
+    Whiteboard whiteboard(1280, 720);
+    whiteboard.setBrushSize(config.brushSize);
+
+    // Full input path per stroke: sampling, simplification and DrawCommand execution
+    results.push_back(measure("stroke_commit", strokes.size(), options.repetitions,
+        [&]() { whiteboard.getStrokes().clear(); },
+        [&]() {
+            for (SyntheticStroke& stroke : strokes) {
+                whiteboard.setColor(stroke.color[0], stroke.color[1], stroke.color[2]);
+                const std::vector<Circle>& path = stroke.circles;
+                double time = 0.0;
+
+                whiteboard.startDrawing(path[0].centerX, path[0].centerY, time);
+                for (size_t c = 1; c < path.size(); c++)
+                    whiteboard.addPoint(path[c].centerX, path[c].centerY, time += 0.004);
+
+                Command* cmd = whiteboard.endDrawing();
+                if (cmd) {
+                    cmd->execute();
+                    delete cmd;
+                }
+            }
+        }));
+
+    // Whole-stroke hit test of every stroke against every eraser position, once per kernel the CPU supports
+    fillBoard(whiteboard, strokes, config.brushSize);
+    size_t hits = 0;
+    CircleHitTest::Kernel bestKernel = CircleHitTest::getKernel();
+    for (int k = 0; k <= (int)bestKernel; k++) {
+        CircleHitTest::Kernel kernel = (CircleHitTest::Kernel)k;
+        CircleHitTest::setKernel(kernel);
+        results.push_back(measure(std::string("erase_hit_test_") + CircleHitTest::getKernelName(kernel),
+            erasers.size() * strokes.size(), options.repetitions,
+            [&]() { hits = 0; },
+            [&]() {
+                const std::vector<Stroke>& board = whiteboard.getStrokes();
+                for (const auto& eraser : erasers) {
+                    for (const Stroke& stroke : board)
+                        hits += whiteboard.strokeIntersectsEraser(stroke, eraser.first, eraser.second, config.brushSize);
+                }
+            }));
+    }
+    CircleHitTest::setKernel(bestKernel);
+
+    // One eraser gesture through every eraser position, each step tests the capsule swept from the previous one
+    results.push_back(measure("erase_sweep", erasers.size(), options.repetitions,
+        [&]() { fillBoard(whiteboard, strokes, config.brushSize); },
+        [&]() {
+            whiteboard.setDrawingMode(Whiteboard::DrawingMode::ERASE);
+            whiteboard.startDrawing(erasers[0].first, erasers[0].second);
+            for (size_t i = 1; i < erasers.size(); i++)
+                whiteboard.addPoint(erasers[i].first, erasers[i].second);
+            delete whiteboard.endDrawing();
+            whiteboard.setDrawingMode(Whiteboard::DrawingMode::DRAW);
+        }));
+
+    // Every stroke committed and then undone, one operation per execute or undo
+    std::vector<DrawCommand*> drawCommands;
+    results.push_back(measure("draw_command_execute_undo", strokes.size() * 2, options.repetitions,
+        [&]() {
+            whiteboard.getStrokes().clear();
+            for (DrawCommand* cmd : drawCommands)
+                delete cmd;
+            drawCommands.clear();
+            for (SyntheticStroke& stroke : strokes)
+                drawCommands.push_back(new DrawCommand(stroke.circles, stroke.color, config.brushSize, BrushType::Round, &whiteboard.getStrokes()));
+        },
+        [&]() {
+            for (DrawCommand* cmd : drawCommands)
+                cmd->execute();
+            for (auto it = drawCommands.rbegin(); it != drawCommands.rend(); ++it)
+                (*it)->undo();
+        }));
+    for (DrawCommand* cmd : drawCommands)
+        delete cmd;
+
+    // Erase every other stroke in one command, then restore them
+    std::vector<int> erased;
+    for (int i = 0; i < (int)strokes.size(); i += 2)
+        erased.push_back(i);
+    results.push_back(measure("erase_command_execute_undo", 2, options.repetitions,
+        [&]() { fillBoard(whiteboard, strokes, config.brushSize); },
+        [&]() {
+            EraseCommand cmd(erased, &whiteboard.getStrokes());
+            cmd.execute();
+            cmd.undo();
+        }));
+
+    // A few circles erased from the middle of one very long stroke; splitting must not walk the whole stroke
+    const unsigned int LONG_STROKE_CIRCLES = 100000;
+    std::vector<Circle> longPath;
+    for (unsigned int i = 0; i < LONG_STROKE_CIRCLES; i++)
+        longPath.emplace_back(-3.0f + 6.0f * i / LONG_STROKE_CIRCLES, 0.0f, config.brushSize);
+    std::vector<float> longColor = { 0.0f, 0.0f, 0.0f };
+    std::vector<std::pair<int, unsigned int>> erasedCircles;
+    for (unsigned int i = 0; i < 16; i++)
+        erasedCircles.push_back({ 0, LONG_STROKE_CIRCLES / 2 + i * 4 });
+    results.push_back(measure("partial_erase_long_stroke", 2, options.repetitions,
+        [&]() {
+            whiteboard.getStrokes().clear();
+            whiteboard.getStrokes().emplace_back(longPath, longColor, config.brushSize);
+        },
+        [&]() {
+            PartialEraseCommand cmd(erasedCircles, &whiteboard.getStrokes());
+            cmd.execute();
+            cmd.undo();
+        }));
+
+    // The board has no file format; the snapshot handed to the render thread is its only serialization
+    BoardSnapshot snapshot;
+    results.push_back(measure("snapshot_publish", 1, options.repetitions,
+        [&]() {
+            fillBoard(whiteboard, strokes, config.brushSize);
+            snapshot = BoardSnapshot();
+        },
+        [&]() { whiteboard.fillSnapshot(snapshot); }));
+
+    if (hits == 0)
+        std::cerr << "Warning: no eraser position hit the board" << std::endl;
+
+    if (options.output.empty()) {
+        writeJson(std::cout, options, results);
+        return 0;
+    }
+
+    std::ofstream file(options.output);
+    if (!file) {
+        std::cerr << "Failed to write " << options.output << std::endl;
+        return 1;
+    }
+    writeJson(file, options, results);
+    return 0;
+}
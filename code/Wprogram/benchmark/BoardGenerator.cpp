@@ -0,0 +1,90 @@
+#include "BoardGenerator.h"
+#include <cmath>
+
+namespace {
+
+    // World extent of a default window, see Whiteboard's projection
+    constexpr float BOARD_HALF_WIDTH = 3.5f;
+    constexpr float BOARD_HALF_HEIGHT = 2.0f;
+    constexpr int CLUSTER_COUNT = 4;
+    constexpr float CLUSTER_RADIUS = 0.4f;
+
+}
+
+const char* getDistributionName(BoardDistribution distribution) {
+    switch (distribution) {
+    case BoardDistribution::Uniform: return "uniform";
+    case BoardDistribution::Clustered: return "clustered";
+    }
+    return "unknown";
+}
+
+bool parseDistribution(const std::string& name, BoardDistribution& distribution) {
+    if (name == "uniform") distribution = BoardDistribution::Uniform;
+    else if (name == "clustered") distribution = BoardDistribution::Clustered;
+    else return false;
+    return true;
+}
+
+BoardGenerator::BoardGenerator(unsigned int seed)
+    : state(seed * 0x9E3779B97F4A7C15ull + 1)
+{
+}
+
+// PCG32
+unsigned int BoardGenerator::next() {
+    unsigned long long old = state;
+    state = old * 6364136223846793005ull + 1442695040888963407ull;
+    unsigned int xorshifted = (unsigned int)(((old >> 18u) ^ old) >> 27u);
+    unsigned int rot = (unsigned int)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+float BoardGenerator::uniform(float min, float max) {
+    return min + (max - min) * ((next() >> 8) * (1.0f / 16777216.0f));
+}
+
+std::vector<SyntheticStroke> BoardGenerator::generate(const BoardConfig& config) {
+    std::vector<SyntheticStroke> strokes;
+    strokes.reserve(config.strokes);
+
+    float clusters[CLUSTER_COUNT][2];
+    for (int i = 0; i < CLUSTER_COUNT; i++) {
+        clusters[i][0] = uniform(-BOARD_HALF_WIDTH, BOARD_HALF_WIDTH);
+        clusters[i][1] = uniform(-BOARD_HALF_HEIGHT, BOARD_HALF_HEIGHT);
+    }
+
+    // Spacing of the stroke sampler, so the generated circles overlap like drawn ones
+    float visibleRadius = 2.0f * config.brushSize * config.brushSize;
+    float step = visibleRadius * 0.4f;
+
+    for (int s = 0; s < config.strokes; s++) {
+        SyntheticStroke stroke;
+        stroke.color = { uniform(0.0f, 1.0f), uniform(0.0f, 1.0f), uniform(0.0f, 1.0f) };
+
+        float x, y;
+        if (config.distribution == BoardDistribution::Clustered) {
+            int cluster = (int)uniform(0.0f, (float)CLUSTER_COUNT);
+            x = clusters[cluster][0] + uniform(-CLUSTER_RADIUS, CLUSTER_RADIUS);
+            y = clusters[cluster][1] + uniform(-CLUSTER_RADIUS, CLUSTER_RADIUS);
+        }
+        else {
+            x = uniform(-BOARD_HALF_WIDTH, BOARD_HALF_WIDTH);
+            y = uniform(-BOARD_HALF_HEIGHT, BOARD_HALF_HEIGHT);
+        }
+
+        // Smooth random walk: the heading drifts a little every step
+        float heading = uniform(0.0f, 6.2831853f);
+        stroke.circles.reserve(config.circlesPerStroke);
+        for (int c = 0; c < config.circlesPerStroke; c++) {
+            stroke.circles.emplace_back(x, y, config.brushSize);
+            heading += uniform(-0.3f, 0.3f);
+            x += std::cos(heading) * step;
+            y += std::sin(heading) * step;
+        }
+
+        strokes.push_back(std::move(stroke));
+    }
+
+    return strokes;
+}
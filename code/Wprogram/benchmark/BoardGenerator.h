@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Circle.h"
+
+enum class BoardDistribution {
+    // Strokes start anywhere on the board
+    Uniform,
+    // Strokes start around a few hot spots, like handwriting in one corner
+    Clustered
+};
+
+struct BoardConfig {
+    unsigned int seed = 1;
+    int strokes = 1000;
+    int circlesPerStroke = 200;
+    float brushSize = 0.3f;
+    BoardDistribution distribution = BoardDistribution::Uniform;
+};
+
+// A stroke as the cursor path that produced it, in world units
+struct SyntheticStroke {
+    std::vector<Circle> circles;
+    std::vector<float> color;
+};
+
+const char* getDistributionName(BoardDistribution distribution);
+
+bool parseDistribution(const std::string& name, BoardDistribution& distribution);
+
+// Same config, same board on the same platform and toolchain: the generator uses its own
+// number mapping instead of the implementation-defined std distributions, but the walk
+// goes through std::cos/std::sin, whose results can differ between math libraries
+class BoardGenerator {
+private:
+    unsigned long long state;
+
+    unsigned int next();
+
+public:
+    explicit BoardGenerator(unsigned int seed);
+
+    // Uniform in [min, max)
+    float uniform(float min, float max);
+
+    std::vector<SyntheticStroke> generate(const BoardConfig& config);
+};
@@ -0,0 +1,23 @@
+#include "AddImageCommand.h"
+
+AddImageCommand::AddImageCommand(const BoardImage& img, std::vector<BoardImage>* imagesRef)
+    : image(img), images(imagesRef)
+{
+}
+
+void AddImageCommand::execute() {
+    images->push_back(image);
+}
+
+void AddImageCommand::undo() {
+    for (auto it = images->begin(); it != images->end(); ++it) {
+        if (it->id == image.id) {
+            images->erase(it);
+            return;
+        }
+    }
+}
+
+size_t AddImageCommand::getMemoryUsage() const {
+    return sizeof(*this) + (size_t)image.pixelWidth * image.pixelHeight * 4;
+}
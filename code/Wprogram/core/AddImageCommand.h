@@ -0,0 +1,19 @@
+#pragma once
+#include "Command.h"
+#include "BoardImage.h"
+#include <vector>
+
+class AddImageCommand : public Command {
+private:
+    BoardImage image;
+    std::vector<BoardImage>* images;
+
+public:
+    AddImageCommand(const BoardImage& img, std::vector<BoardImage>* imagesRef);
+
+    void execute() override;
+
+    void undo() override;
+
+    size_t getMemoryUsage() const override;
+};
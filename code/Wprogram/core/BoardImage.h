@@ -0,0 +1,17 @@
+#pragma once
+#include <memory>
+
+// A picture placed on the board. Pixels are RGBA8 with the top row first and are
+// shared between the board, the undo history and the renderer, never copied.
+struct BoardImage {
+    int id;
+    int pixelWidth;
+    int pixelHeight;
+    std::shared_ptr<const unsigned char> pixels;
+
+    // World-space placement
+    float centerX;
+    float centerY;
+    float width;
+    float height;
+};
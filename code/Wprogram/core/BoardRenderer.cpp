@@ -0,0 +1,543 @@
+#include "BoardRenderer.h"
+
+BoardRenderer::BoardRenderer() {
+    float positions[] = {
+        // positions      // texture coords
+        -0.5f, -0.5f,     0.0f, 0.0f,  // Bottom-left
+         0.5f, -0.5f,     1.0f, 0.0f,  // Bottom-right
+         0.5f,  0.5f,     1.0f, 1.0f,  // Top-right
+        -0.5f,  0.5f,     0.0f, 1.0f   // Top-left
+    };
+    unsigned int indices[] = {
+           0, 1, 2,
+           2, 3, 0
+    };
+
+    vb = new VertexBuffer(positions, sizeof(positions));
+    ib = new IndexBuffer(indices, 6);
+    shader=new Shader(std::string(SHADER_PATH) + "/Basic.shader", SHADER_CACHE_PATH);
+    renderer = &Renderer::getInstance();
+
+    instanceLayout.Push<float>(3);
+    instanceLayout.Push<float>(4);
+    instanceLayout.Push<float>(1);
+    instanceLayout.Push<float>(4);
+    instanceLayout.Push<float>(1);
+    instanceLayout.Push<float>(1);
+
+    brushAtlas = new BrushAtlas();
+
+    createQuadVertexArray(committedVa);
+    committedInstances = new VertexBuffer(nullptr, 0, BufferUsage::Dynamic);
+    committedVa->AddInstanceBuffer(*committedInstances, instanceLayout);
+    createQuadVertexArray(liveVa);
+
+    liveInstances = new StreamBuffer(LIVE_STREAM_CAPACITY);
+    liveVa->AddInstanceBuffer(liveInstances->GetBuffer(), instanceLayout);
+    streamedCount = 0;
+    drawnCircles = 0;
+
+    createQuadVertexArray(predictedVa);
+    predictedInstances = new VertexBuffer(nullptr, 0, BufferUsage::Stream);
+    predictedVa->AddInstanceBuffer(*predictedInstances, instanceLayout);
+
+    circleCenterUniform = shader->GetUniform<glm::vec2>("circleCenter");
+    shader->Bind();
+    shader->SetUniform(shader->GetUniform<int>("u_Atlas"), 0);
+    shader->SetUniform(shader->GetUniform<int>("u_Highlight"), HIGHLIGHT_SLOT);
+
+    highlight = new TextureBuffer();
+    highlightSession = 0;
+    highlightedStrokes = 0;
+    highlightedCircles = 0;
+
+    imageShader = new Shader(std::string(SHADER_PATH) + "/Image.shader", SHADER_CACHE_PATH);
+    imageInstanceLayout.Push<float>(4);
+    imageInstanceLayout.Push<float>(4);
+    createQuadVertexArray(imageVa);
+    imageInstances = new VertexBuffer(nullptr, 0, BufferUsage::Dynamic);
+    imageVa->AddInstanceBuffer(*imageInstances, imageInstanceLayout);
+    textureUploader = new TextureUploader();
+
+    int maxTextureSize = 0;
+    GLCall(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize));
+    imageTileSize = std::min(std::max(maxTextureSize, 1024), MAX_IMAGE_TILE_SIZE);
+
+    imageShader->Bind();
+    imageShader->SetUniform(imageShader->GetUniform<int>("u_Texture"), 0);
+
+    frameConstants = new UniformBuffer(sizeof(FrameConstants), FRAME_CONSTANTS_BINDING);
+    shader->BindUniformBlock("FrameConstants", FRAME_CONSTANTS_BINDING);
+    imageShader->BindUniformBlock("FrameConstants", FRAME_CONSTANTS_BINDING);
+}
+
+BoardRenderer::~BoardRenderer() {
+    delete committedVa;
+    delete committedInstances;
+    delete liveVa;
+    delete liveInstances;
+    delete predictedVa;
+    delete predictedInstances;
+    delete vb;
+    delete ib;
+    delete shader;
+    delete frameConstants;
+    delete brushAtlas;
+    delete highlight;
+
+    for (auto& entry : uploadedImages) {
+        for (ImageTile& tile : entry.second.tiles)
+            delete tile.texture;
+    }
+    delete imageVa;
+    delete imageInstances;
+    delete imageShader;
+    delete textureUploader;
+}
+
+void BoardRenderer::createQuadVertexArray(VertexArray*& vertexArray) {
+    vertexArray = new VertexArray();
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    vertexArray->AddBuffer(*vb, layout);
+    ib->Bind();
+}
+
+BoardRenderer::CircleInstance BoardRenderer::makeCircleInstance(const Circle& circle, const Circle* previous,
+    int highlightIndex, const std::vector<float>& color, float brushSize, BrushType brush) const {
+    // Markers follow the stroke direction, grainy brushes get a stable pseudo-random turn per stamp.
+    // The turn is keyed by position so a stamp looks the same live, committed and after a split.
+    float rotation = 0.0f;
+    if (brush == BrushType::Marker && previous)
+        rotation = atan2(circle.centerY - previous->centerY, circle.centerX - previous->centerX);
+    else if (brush == BrushType::Pencil || brush == BrushType::Chalk) {
+        unsigned int x, y;
+        std::memcpy(&x, &circle.centerX, sizeof(x));
+        std::memcpy(&y, &circle.centerY, sizeof(y));
+        unsigned int hash = (x ^ (y * 0x9E3779B9u)) * 2654435761u;
+        rotation = ((hash >> 16) & 0xFFFF) / 65536.0f * 6.2831853f;
+    }
+
+    const glm::vec4& atlasRect = brushAtlas->getRect(brush);
+
+    return {
+        circle.centerX, circle.centerY, circle.raduis * 2.0f,
+        color[0], color[1], color[2], 1.0f,
+        brushSize,
+        atlasRect.x, atlasRect.y, atlasRect.z, atlasRect.w,
+        rotation,
+        (float)highlightIndex
+    };
+}
+
+void BoardRenderer::rebuildCommitted(const BoardSnapshot& board) {
+    PROFILE_ZONE("BoardRenderer::rebuildCommitted");
+    const std::vector<Stroke>& strokes = *board.strokes;
+
+    committedData.clear();
+    strokeRanges.clear();
+    circleInstances.clear();
+    strokeCircleBase.clear();
+
+    for (int i = 0; i < strokes.size(); i++) {
+        const Stroke& stroke = strokes[i];
+        unsigned int first = (unsigned int)committedData.size();
+        float spacing = StrokeSampler::spacingFor(stroke.brushSize);
+
+        strokeCircleBase.push_back((unsigned int)circleInstances.size());
+
+        for (unsigned int c = 0; c < stroke.size(); c++) {
+            const Circle& circle = stroke[c];
+            const Circle* previous = stroke.offset + c > 0 ? &(*stroke.storage)[stroke.offset + c - 1] : nullptr;
+
+            // Refill the span the simplifier removed, evenly at roughly the sampler's spacing
+            if (c > 0) {
+                float dx = circle.centerX - previous->centerX;
+                float dy = circle.centerY - previous->centerY;
+                float distance = std::sqrt(dx * dx + dy * dy);
+                if (distance > spacing * REDENSIFY_THRESHOLD) {
+                    int steps = (int)std::ceil(distance / spacing);
+                    Circle last = *previous;
+                    for (int s = 1; s < steps; s++) {
+                        float t = (float)s / steps;
+                        Circle fill(previous->centerX + dx * t, previous->centerY + dy * t,
+                            previous->raduis + (circle.raduis - previous->raduis) * t);
+                        committedData.push_back(makeCircleInstance(fill, &last,
+                            (int)committedData.size(), stroke.color, stroke.brushSize, stroke.brush));
+                        last = fill;
+                    }
+                }
+            }
+
+            circleInstances.push_back((unsigned int)committedData.size());
+            committedData.push_back(makeCircleInstance(circle, previous,
+                (int)committedData.size(), stroke.color, stroke.brushSize, stroke.brush));
+        }
+
+        strokeRanges.push_back({ first, (unsigned int)committedData.size() - first });
+    }
+
+    committedInstances->SetData(committedData.data(), committedData.size() * sizeof(CircleInstance));
+
+    // Instance positions changed, so the erase preview is re-applied from scratch
+    highlightData.assign(committedData.size(), 0);
+    highlight->Allocate(highlightData.data(), highlightData.size());
+    highlightedStrokes = 0;
+    highlightedCircles = 0;
+
+    uploadedStrokes = board.strokes;
+}
+
+void BoardRenderer::updateHighlight(const BoardSnapshot& board) {
+    size_t dirtyBegin = highlightData.size();
+    size_t dirtyEnd = 0;
+
+    auto mark = [&](size_t first, size_t count, unsigned char value) {
+        if (count == 0) return;
+        std::fill(highlightData.begin() + first, highlightData.begin() + first + count, value);
+        dirtyBegin = std::min(dirtyBegin, first);
+        dirtyEnd = std::max(dirtyEnd, first + count);
+    };
+
+    // A new gesture starts from an empty preview; within one, both lists only grow
+    if (board.eraseSession != highlightSession
+        || board.erasedStrokeIndices.size() < highlightedStrokes
+        || board.erasedCircles.size() < highlightedCircles) {
+        if (highlightedStrokes > 0 || highlightedCircles > 0)
+            mark(0, highlightData.size(), 0);
+        highlightedStrokes = 0;
+        highlightedCircles = 0;
+        highlightSession = board.eraseSession;
+    }
+
+    // Only entries added since the last frame are applied
+    for (size_t i = highlightedStrokes; i < board.erasedStrokeIndices.size(); i++) {
+        int stroke = board.erasedStrokeIndices[i];
+        if (stroke >= 0 && stroke < strokeRanges.size())
+            mark(strokeRanges[stroke].first, strokeRanges[stroke].second, 255);
+    }
+    highlightedStrokes = board.erasedStrokeIndices.size();
+
+    for (size_t i = highlightedCircles; i < board.erasedCircles.size(); i++) {
+        const auto& erased = board.erasedCircles[i];
+        if (erased.first < 0 || erased.first >= strokeCircleBase.size()) continue;
+
+        // Erasing a circle also drops the fill on both sides of it
+        unsigned int base = strokeCircleBase[erased.first];
+        unsigned int count = (erased.first + 1 < strokeCircleBase.size() ? strokeCircleBase[erased.first + 1] : circleInstances.size()) - base;
+        if (erased.second >= count) continue;
+
+        unsigned int circle = base + erased.second;
+        size_t first = erased.second > 0 ? circleInstances[circle - 1] + 1 : circleInstances[circle];
+        size_t last = erased.second + 1 < count ? circleInstances[circle + 1] : circleInstances[circle] + 1;
+        mark(first, last - first, 255);
+    }
+    highlightedCircles = board.erasedCircles.size();
+
+    if (dirtyBegin < dirtyEnd)
+        highlight->SetData(highlightData.data() + dirtyBegin, dirtyEnd - dirtyBegin, dirtyBegin);
+}
+
+void BoardRenderer::streamLiveStroke(const BoardSnapshot& board) {
+    if (board.liveStroke != streamedStroke) {
+        liveInstances->BeginRun(sizeof(CircleInstance));
+        streamedStroke = board.liveStroke;
+        streamedCount = 0;
+    }
+
+    // Circles already in the run never change, only the new tail is written
+    liveData.clear();
+    for (size_t i = streamedCount; i < board.liveCircleCount; i++) {
+        const Circle* previous = i > 0 ? &(*board.liveStroke)[i - 1] : nullptr;
+        liveData.push_back(makeCircleInstance((*board.liveStroke)[i], previous, -1, board.currentColor, board.currentBrushSize, board.currentBrush));
+    }
+    liveInstances->Append(liveData.data(), liveData.size() * sizeof(CircleInstance));
+    streamedCount = board.liveCircleCount;
+}
+
+void BoardRenderer::uploadPrediction(const BoardSnapshot& board) {
+    predictedData.clear();
+    const Circle* previous = board.liveCircleCount > 0 ? &(*board.liveStroke)[board.liveCircleCount - 1] : nullptr;
+    for (const Circle& circle : board.predictedCircles) {
+        predictedData.push_back(makeCircleInstance(circle, previous, -1,
+            board.currentColor, board.currentBrushSize, board.currentBrush));
+        previous = &circle;
+    }
+    predictedInstances->SetData(predictedData.data(), predictedData.size() * sizeof(CircleInstance));
+}
+
+void BoardRenderer::syncImages(const BoardSnapshot& board) {
+    const std::vector<BoardImage>& images = *board.images;
+
+    // Drop images that were undone or cleared
+    for (auto it = uploadedImages.begin(); it != uploadedImages.end();) {
+        bool alive = std::any_of(images.begin(), images.end(),
+            [&](const BoardImage& image) { return image.id == it->first; });
+        if (alive) {
+            ++it;
+            continue;
+        }
+        for (ImageTile& tile : it->second.tiles)
+            delete tile.texture;
+        it = uploadedImages.erase(it);
+    }
+
+    imageData.clear();
+    for (const BoardImage& image : images) {
+        UploadedImage& uploaded = uploadedImages[image.id];
+
+        if (uploaded.tiles.empty()) {
+            uploaded.pixels = image.pixels;
+            uploaded.pixelWidth = image.pixelWidth;
+            for (int y = 0; y < image.pixelHeight; y += imageTileSize) {
+                for (int x = 0; x < image.pixelWidth; x += imageTileSize) {
+                    int width = std::min(imageTileSize, image.pixelWidth - x);
+                    int height = std::min(imageTileSize, image.pixelHeight - y);
+                    uploaded.tiles.push_back({ new Texture(width, height, true), x, y, width, height, 0 });
+                }
+            }
+        }
+
+        // Texture row 0 holds the top row of the tile, so v runs from 1 at the bottom edge to 0 at the top
+        float worldPerPixelX = image.width / image.pixelWidth;
+        float worldPerPixelY = image.height / image.pixelHeight;
+        float left = image.centerX - image.width * 0.5f;
+        float top = image.centerY + image.height * 0.5f;
+
+        uploaded.firstInstance = imageData.size();
+        for (const ImageTile& tile : uploaded.tiles) {
+            float width = tile.width * worldPerPixelX;
+            float height = tile.height * worldPerPixelY;
+            imageData.push_back({
+                left + tile.x * worldPerPixelX + width * 0.5f,
+                top - tile.y * worldPerPixelY - height * 0.5f,
+                width, height,
+                0.0f, 1.0f, 1.0f, 0.0f
+            });
+        }
+    }
+
+    imageInstances->SetData(imageData.data(), imageData.size() * sizeof(ImageInstance));
+    drawnImages = board.images;
+}
+
+void BoardRenderer::uploadImageTiles(const BoardSnapshot& board) {
+    unsigned int budget = IMAGE_UPLOAD_BUDGET;
+
+    for (const BoardImage& image : *board.images) {
+        UploadedImage& uploaded = uploadedImages[image.id];
+        unsigned int stride = uploaded.pixelWidth * 4;
+
+        for (ImageTile& tile : uploaded.tiles) {
+            if (tile.uploadedRows == tile.height) continue;
+            if (budget == 0) return;
+
+            unsigned int rowSize = tile.width * 4;
+            int rows = std::min(tile.height - tile.uploadedRows, (int)std::max(budget / rowSize, 1u));
+
+            const unsigned char* source = uploaded.pixels.get()
+                + (size_t)(tile.y + tile.uploadedRows) * stride + (size_t)tile.x * 4;
+            textureUploader->Upload(*tile.texture, 0, tile.uploadedRows, tile.width, rows, source, stride);
+
+            tile.uploadedRows += rows;
+            budget -= std::min(budget, rows * rowSize);
+
+            if (tile.uploadedRows == tile.height)
+                tile.texture->GenerateMipmaps();
+        }
+    }
+}
+
+void BoardRenderer::render(const BoardSnapshot& board, const glm::vec4& viewport, GpuProfiler* profiler) {
+    PROFILE_ZONE("BoardRenderer::render");
+
+    auto beginPass = [&](const char* name) {
+        if (profiler) profiler->BeginPass(name);
+    };
+    auto endPass = [&]() {
+        renderer->Flush();
+        if (profiler) profiler->EndPass();
+    };
+
+    beginPass("Clear");
+    renderer->Clear();
+    endPass();
+
+    shader->Bind();
+
+    FrameConstants constants;
+    constants.viewProjection = board.proj * board.view;
+    constants.viewport = viewport;
+    frameConstants->SetData(&constants, sizeof(constants));
+
+    shader->SetUniform(circleCenterUniform, glm::vec2(0.5f, 0.5f));
+
+    if (board.strokes != uploadedStrokes)
+        rebuildCommitted(board);
+    updateHighlight(board);
+    highlight->Bind(HIGHLIGHT_SLOT);
+
+    beginPass("Images");
+    if (board.images) {
+        if (board.images != drawnImages)
+            syncImages(board);
+        uploadImageTiles(board);
+
+        // Texture is left out of the key so overlapping images keep their board order
+        DrawPacket imagePacket;
+        imagePacket.SortKey = Renderer::MakeSortKey(IMAGE_LAYER, imageShader, nullptr, BlendMode::Alpha);
+        imagePacket.VA = imageVa;
+        imagePacket.IB = ib;
+        imagePacket.Program = imageShader;
+        imagePacket.Blend = BlendMode::Alpha;
+        imagePacket.InstanceCount = 1;
+
+        for (const BoardImage& image : *board.images) {
+            const UploadedImage& uploaded = uploadedImages[image.id];
+            for (unsigned int i = 0; i < uploaded.tiles.size(); i++) {
+                const ImageTile& tile = uploaded.tiles[i];
+                if (tile.uploadedRows < tile.height) continue;
+
+                imagePacket.Tex = tile.texture;
+                imagePacket.FirstInstance = uploaded.firstInstance + i;
+                renderer->Submit(imagePacket);
+            }
+        }
+    }
+
+    endPass();
+
+    // One packet per stroke; consecutive strokes share all state and merge into a single draw
+    beginPass("Committed");
+    DrawPacket packet;
+    packet.SortKey = Renderer::MakeSortKey(COMMITTED_LAYER, shader, brushAtlas->getTexture(), BlendMode::Alpha);
+    packet.VA = committedVa;
+    packet.IB = ib;
+    packet.Program = shader;
+    packet.Tex = brushAtlas->getTexture();
+    packet.Blend = BlendMode::Alpha;
+
+    for (const auto& range : strokeRanges) {
+        if (range.second == 0) continue;
+
+        packet.FirstInstance = range.first;
+        packet.InstanceCount = range.second;
+        renderer->Submit(packet);
+    }
+    drawnCircles = committedData.size();
+    endPass();
+
+    beginPass("Live");
+    if (board.isDrawing && board.liveStroke && board.liveCircleCount > 0) {
+        streamLiveStroke(board);
+
+        packet.SortKey = Renderer::MakeSortKey(LIVE_LAYER, shader, brushAtlas->getTexture(), BlendMode::Alpha);
+        packet.VA = liveVa;
+        packet.FirstInstance = liveInstances->GetRunOffset() / sizeof(CircleInstance);
+        packet.InstanceCount = liveInstances->GetRunSize() / sizeof(CircleInstance);
+        renderer->Submit(packet);
+        drawnCircles += packet.InstanceCount;
+
+        if (!board.predictedCircles.empty()) {
+            uploadPrediction(board);
+
+            packet.SortKey = Renderer::MakeSortKey(PREDICTED_LAYER, shader, brushAtlas->getTexture(), BlendMode::Alpha);
+            packet.VA = predictedVa;
+            packet.FirstInstance = 0;
+            packet.InstanceCount = (unsigned int)predictedData.size();
+            renderer->Submit(packet);
+            drawnCircles += packet.InstanceCount;
+        }
+    }
+    endPass();
+
+    liveInstances->Fence();
+}
+
+bool BoardRenderer::saveDrawing(const std::string& filename,int sidebarWidth,int windowWidth,int windowHeight) {
+    PROFILE_ZONE("BoardRenderer::saveDrawing");
+    int drawingWidth = windowWidth - sidebarWidth;
+    int drawingHeight = windowHeight;
+
+    unsigned char* pixels = new unsigned char[drawingWidth * drawingHeight * 4];
+
+    glReadPixels(
+        sidebarWidth,      // x: skip sidebar
+        0,                 // y: from bottom
+        drawingWidth,      // width: drawing area only
+        drawingHeight,     // height: full height
+        GL_RGBA,           // format: Red, Green, Blue, Alpha
+        GL_UNSIGNED_BYTE,  // type: 8-bit unsigned byte per channel
+        pixels             // destination buffer
+    );
+
+    // Flip image vertically (OpenGL is bottom-to-top, images are top-to-bottom)
+    unsigned char* flippedPixels = new unsigned char[drawingWidth * drawingHeight * 4];
+    for (int y = 0; y < drawingHeight; y++) {
+        memcpy(
+            flippedPixels + (drawingHeight - 1 - y) * drawingWidth * 4,
+            pixels + y * drawingWidth * 4,
+            drawingWidth * 4
+        );
+    }
+
+    // Get file extension
+    std::string ext = "";
+    size_t dotPos = filename.find_last_of(".");
+    if (dotPos != std::string::npos) {
+        ext = filename.substr(dotPos + 1);
+        // Convert to lowercase
+        for (char& c : ext) {
+            c = tolower(c);
+        }
+    }
+
+    int result = 0;
+
+    if (ext == "png") {
+        result = stbi_write_png(
+            filename.c_str(),        // filename
+            drawingWidth,            // width
+            drawingHeight,           // height
+            4,                       // channels (RGBA)
+            flippedPixels,          // pixel data
+            drawingWidth * 4        // stride (bytes per row)
+        );
+    }
+    else if (ext == "jpg" || ext == "jpeg") {
+        result = stbi_write_jpg(
+            filename.c_str(),        // filename
+            drawingWidth,            // width
+            drawingHeight,           // height
+            4,                       // channels (RGBA)
+            flippedPixels,          // pixel data
+            95                      // quality (1-100, 95 is high quality)
+        );
+    }
+    else if (ext == "bmp") {
+        result = stbi_write_bmp(
+            filename.c_str(),        // filename
+            drawingWidth,            // width
+            drawingHeight,           // height
+            4,                       // channels (RGBA)
+            flippedPixels           // pixel data
+        );
+    }
+    else {
+        std::string pngFilename = filename + ".png";
+        result = stbi_write_png(
+            pngFilename.c_str(),
+            drawingWidth,
+            drawingHeight,
+            4,
+            flippedPixels,
+            drawingWidth * 4
+        );
+    }
+
+    delete[] pixels;
+    delete[] flippedPixels;
+
+    return result != 0;
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include "BoardSnapshot.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "StreamBuffer.h"
+#include "VertexBufferLayout.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "TextureUploader.h"
+#include "TextureBuffer.h"
+#include "BrushAtlas.h"
+#include "StrokeSampler.h"
+#include "UniformBuffer.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include "Renderer.h"
+#include "glm/glm.hpp"
+#include <stb_image_write.h>
+
+// Owns the GL resources used to draw a board, must live on the thread that owns the GL context.
+class BoardRenderer {
+private:
+    // Unit quad shared by every circle, circles themselves are per-instance data
+    VertexBuffer* vb;
+    IndexBuffer* ib;
+    Shader* shader;
+    Renderer* renderer;
+
+    // Must match the per-instance attributes in Basic.shader
+    struct CircleInstance {
+        float centerX, centerY, diameter;
+        float r, g, b, a;
+        float radius;
+        float u0, v0, u1, v1;
+        float rotation;
+        // Slot in the erase highlight buffer, -1 for the live stroke
+        float highlightIndex;
+    };
+    VertexBufferLayout instanceLayout;
+
+    // Every brush samples the same atlas, so switching brushes never splits a batch
+    BrushAtlas* brushAtlas;
+
+    static constexpr unsigned int IMAGE_LAYER = 0;
+    static constexpr unsigned int COMMITTED_LAYER = 1;
+    static constexpr unsigned int LIVE_LAYER = 2;
+    static constexpr unsigned int PREDICTED_LAYER = 3;
+    static constexpr unsigned int LIVE_STREAM_CAPACITY = 1 << 20;
+
+    // Committed strokes, rebuilt only when the snapshot's stroke list or erase preview changes
+    VertexArray* committedVa;
+    VertexBuffer* committedInstances;
+    std::vector<CircleInstance> committedData;
+    std::vector<std::pair<unsigned int, unsigned int>> strokeRanges;
+    // Stored strokes are simplified, so gaps wider than REDENSIFY_THRESHOLD sampler spacings are
+    // refilled with interpolated instances. circleInstances maps each stored circle to its own
+    // instance; strokeCircleBase[i] is where stroke i starts in it.
+    static constexpr float REDENSIFY_THRESHOLD = 1.5f;
+    std::vector<unsigned int> circleInstances;
+    std::vector<unsigned int> strokeCircleBase;
+    std::shared_ptr<const std::vector<Stroke>> uploadedStrokes;
+
+    // Erase preview: one byte per committed instance, read by the shader to dim erased circles.
+    // Only the entries touched since the last frame are uploaded, the instances are never rebuilt.
+    static constexpr unsigned int HIGHLIGHT_SLOT = 1;
+    TextureBuffer* highlight;
+    std::vector<unsigned char> highlightData;
+    unsigned long long highlightSession;
+    size_t highlightedStrokes;
+    size_t highlightedCircles;
+
+    // In-progress stroke, streamed a few circles per frame instead of re-uploaded
+    VertexArray* liveVa;
+    StreamBuffer* liveInstances;
+    std::vector<CircleInstance> liveData;
+    std::shared_ptr<const LiveStroke> streamedStroke;
+    size_t streamedCount;
+
+    // Predicted tail of the live stroke, a handful of instances replaced every frame
+    VertexArray* predictedVa;
+    VertexBuffer* predictedInstances;
+    std::vector<CircleInstance> predictedData;
+
+    // Imported images. Each is split into tiles no larger than the texture size limit,
+    // and tiles are filled a few rows per frame so large pictures never stall a frame.
+    struct ImageInstance {
+        float centerX, centerY, width, height;
+        float u0, v0, u1, v1;
+    };
+    struct ImageTile {
+        Texture* texture;
+        int x, y, width, height;
+        int uploadedRows;
+    };
+    struct UploadedImage {
+        std::shared_ptr<const unsigned char> pixels;
+        int pixelWidth;
+        std::vector<ImageTile> tiles;
+        unsigned int firstInstance;
+    };
+    static constexpr int MAX_IMAGE_TILE_SIZE = 4096;
+    static constexpr unsigned int IMAGE_UPLOAD_BUDGET = 16 << 20;
+
+    Shader* imageShader;
+    VertexArray* imageVa;
+    VertexBuffer* imageInstances;
+    VertexBufferLayout imageInstanceLayout;
+    std::vector<ImageInstance> imageData;
+    std::unordered_map<int, UploadedImage> uploadedImages;
+    std::shared_ptr<const std::vector<BoardImage>> drawnImages;
+    TextureUploader* textureUploader;
+    int imageTileSize;
+
+    // Per-frame constants, must match the FrameConstants block in Basic.shader (std140)
+    struct FrameConstants {
+        glm::mat4 viewProjection;
+        glm::vec4 viewport;
+    };
+    static constexpr unsigned int FRAME_CONSTANTS_BINDING = 0;
+    UniformBuffer* frameConstants;
+
+    Uniform<glm::vec2> circleCenterUniform;
+
+    size_t drawnCircles;
+
+    void createQuadVertexArray(VertexArray*& vertexArray);
+
+    CircleInstance makeCircleInstance(const Circle& circle, const Circle* previous, int highlightIndex, const std::vector<float>& color, float brushSize, BrushType brush) const;
+
+    void rebuildCommitted(const BoardSnapshot& board);
+
+    void updateHighlight(const BoardSnapshot& board);
+
+    void streamLiveStroke(const BoardSnapshot& board);
+
+    void uploadPrediction(const BoardSnapshot& board);
+
+    void syncImages(const BoardSnapshot& board);
+
+    void uploadImageTiles(const BoardSnapshot& board);
+
+public:
+    BoardRenderer();
+
+    ~BoardRenderer();
+
+    BoardRenderer(const BoardRenderer&) = delete;
+    BoardRenderer& operator=(const BoardRenderer&) = delete;
+
+    // viewport is x, y, width, height of the drawing area in framebuffer pixels
+    // Each pass is flushed on its own so the profiler, when given, can time it
+    void render(const BoardSnapshot& board, const glm::vec4& viewport, GpuProfiler* profiler = nullptr);
+
+    // Circle instances drawn by the last render(), committed, live and predicted
+    size_t getDrawnCircles() const { return drawnCircles; }
+
+    bool saveDrawing(const std::string& filename, int sidebarWidth, int windowWidth, int windowHeight);
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Stroke.h"
+#include "BoardImage.h"
+#include "Circle.h"
+#include "LiveStroke.h"
+#include "glm/glm.hpp"
+
+// Immutable view of the board handed from the input thread to the render thread.
+// Committed strokes and images are shared and only re-copied when a command changes them.
+struct BoardSnapshot {
+    std::shared_ptr<const std::vector<Stroke>> strokes;
+    std::shared_ptr<const std::vector<BoardImage>> images;
+    // The in-progress stroke is shared, only the first liveCircleCount circles belong to this snapshot
+    std::shared_ptr<const LiveStroke> liveStroke;
+    size_t liveCircleCount = 0;
+    // Predicted continuation of the live stroke, display only
+    std::vector<Circle> predictedCircles;
+    // Input timestamps of the live circles that first appear in this snapshot
+    std::vector<double> inputTimes;
+    std::vector<int> erasedStrokeIndices;
+    std::vector<std::pair<int, unsigned int>> erasedCircles;
+    // Changes with every new pointer gesture, both erase lists only grow within one
+    unsigned long long eraseSession = 0;
+
+    std::vector<float> currentColor;
+    float currentBrushSize = 0.0f;
+    BrushType currentBrush = BrushType::Round;
+    bool isDrawing = false;
+
+    glm::mat4 proj = glm::mat4(1.0f);
+    glm::mat4 view = glm::mat4(1.0f);
+};
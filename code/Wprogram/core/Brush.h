@@ -0,0 +1,20 @@
+#pragma once
+
+// Round is the original solid circle; the others are textured stamps from the brush atlas
+enum class BrushType {
+    Round,
+    Pencil,
+    Marker,
+    Chalk
+};
+
+constexpr int BRUSH_TYPE_COUNT = 4;
+
+inline const char* getBrushName(BrushType brush) {
+    switch (brush) {
+        case BrushType::Pencil: return "Pencil";
+        case BrushType::Marker: return "Marker";
+        case BrushType::Chalk: return "Chalk";
+        default: return "Round";
+    }
+}
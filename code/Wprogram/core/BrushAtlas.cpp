@@ -0,0 +1,110 @@
+#include "BrushAtlas.h"
+#include <vector>
+#include <cmath>
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+namespace {
+
+    // Cheap integer hash, good enough for paper grain
+    float grain(int x, int y, int seed) {
+        unsigned int h = (unsigned int)x * 374761393u + (unsigned int)y * 668265263u + (unsigned int)seed * 2246822519u;
+        h = (h ^ (h >> 13)) * 1274126177u;
+        h ^= h >> 16;
+        return (h & 0xFFFF) / 65535.0f;
+    }
+
+    float smoothstep(float edge0, float edge1, float x) {
+        float t = std::fmin(std::fmax((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    int stampSize(BrushType brush) {
+        return brush == BrushType::Chalk ? 128 : 64;
+    }
+
+    // Coverage of the stamp at x, y, where both run from -1 to 1 across the stamp
+    float stampCoverage(BrushType brush, float x, float y, int px, int py) {
+        float r = std::sqrt(x * x + y * y);
+
+        switch (brush) {
+            case BrushType::Pencil: {
+                float body = 1.0f - smoothstep(0.7f, 1.0f, r);
+                return body * (grain(px, py, 1) > 0.45f ? 0.85f : 0.3f);
+            }
+            case BrushType::Marker: {
+                // Flat chisel tip, the renderer turns it along the stroke
+                float e = std::sqrt(x * x + (y / 0.35f) * (y / 0.35f));
+                return (1.0f - smoothstep(0.85f, 1.0f, e)) * 0.5f;
+            }
+            case BrushType::Chalk: {
+                float angle = std::atan2(y, x);
+                float edge = 0.75f + 0.25f * grain((int)((angle + 3.14159265f) * 8.0f), 0, 3);
+                if (r > edge) return 0.0f;
+                return grain(px, py, 2) > 0.3f ? 0.9f : 0.0f;
+            }
+            default:
+                return 1.0f;
+        }
+    }
+
+}
+
+BrushAtlas::BrushAtlas() {
+    std::vector<stbrp_rect> packRects;
+    for (int i = 0; i < BRUSH_TYPE_COUNT; i++) {
+        rects[i] = glm::vec4(0.0f);
+        if ((BrushType)i == BrushType::Round) continue;
+
+        stbrp_rect rect = {};
+        rect.id = i;
+        rect.w = rect.h = stampSize((BrushType)i) + STAMP_PADDING * 2;
+        packRects.push_back(rect);
+    }
+
+    stbrp_context context;
+    std::vector<stbrp_node> nodes(ATLAS_SIZE);
+    stbrp_init_target(&context, ATLAS_SIZE, ATLAS_SIZE, nodes.data(), (int)nodes.size());
+    stbrp_pack_rects(&context, packRects.data(), (int)packRects.size());
+
+    // White texels, the stamp mask lives in alpha and is tinted by the stroke color
+    std::vector<unsigned char> pixels(ATLAS_SIZE * ATLAS_SIZE * 4, 0);
+    for (int i = 0; i < ATLAS_SIZE * ATLAS_SIZE; i++) {
+        pixels[i * 4 + 0] = 255;
+        pixels[i * 4 + 1] = 255;
+        pixels[i * 4 + 2] = 255;
+    }
+
+    for (const stbrp_rect& rect : packRects) {
+        // Brushes that do not fit fall back to the round brush
+        if (!rect.was_packed) continue;
+
+        BrushType brush = (BrushType)rect.id;
+        int size = stampSize(brush);
+        int left = rect.x + STAMP_PADDING;
+        int top = rect.y + STAMP_PADDING;
+
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                float sx = (x + 0.5f) / size * 2.0f - 1.0f;
+                float sy = (y + 0.5f) / size * 2.0f - 1.0f;
+                float coverage = stampCoverage(brush, sx, sy, x, y);
+                pixels[((top + y) * ATLAS_SIZE + left + x) * 4 + 3] = (unsigned char)(coverage * 255.0f + 0.5f);
+            }
+        }
+
+        rects[rect.id] = glm::vec4(
+            (float)left / ATLAS_SIZE, (float)top / ATLAS_SIZE,
+            (float)(left + size) / ATLAS_SIZE, (float)(top + size) / ATLAS_SIZE);
+    }
+
+    texture = new Texture(ATLAS_SIZE, ATLAS_SIZE, true);
+    texture->SetSubImage(0, 0, ATLAS_SIZE, ATLAS_SIZE, pixels.data());
+    texture->GenerateMipmaps();
+}
+
+BrushAtlas::~BrushAtlas() {
+    delete texture;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Brush.h"
+#include "Texture.h"
+#include "glm/glm.hpp"
+
+// Stamp masks for the textured brushes, packed into a single texture so every brush
+// draws through the same instanced circle path without extra texture binds.
+// Must be created and destroyed on the thread that owns the GL context.
+class BrushAtlas {
+private:
+    static constexpr int ATLAS_SIZE = 256;
+    static constexpr int STAMP_PADDING = 2;
+
+    Texture* texture;
+    // u0, v0, u1, v1 per brush; Round has an empty rectangle and is drawn procedurally
+    glm::vec4 rects[BRUSH_TYPE_COUNT];
+
+public:
+    BrushAtlas();
+
+    ~BrushAtlas();
+
+    BrushAtlas(const BrushAtlas&) = delete;
+    BrushAtlas& operator=(const BrushAtlas&) = delete;
+
+    const Texture* getTexture() const { return texture; }
+
+    const glm::vec4& getRect(BrushType brush) const { return rects[(int)brush]; }
+};
@@ -0,0 +1,265 @@
+#include "CircleHitTest.h"
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CIRCLE_HIT_TEST_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit vector instructions in functions marked for them; MSVC needs no marking
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+CircleArrays::CircleArrays(const std::vector<Circle>& circles) {
+    x.reserve(circles.size());
+    y.reserve(circles.size());
+    radius.reserve(circles.size());
+    for (const Circle& circle : circles) {
+        x.push_back(circle.centerX);
+        y.push_back(circle.centerY);
+        radius.push_back(circle.raduis);
+    }
+}
+
+namespace {
+
+    // A query prepared once for a whole run: the closest point of the segment a + t * d, t in [0, 1],
+    // is found from the projection onto d. A point query is the segment of length 0.
+    struct Query {
+        float ax, ay;
+        float dx, dy;
+        // 1 / |d|^2, or 0 for a point so t stays 0
+        float inverseLengthSquared;
+        float radius;
+    };
+
+    Query makeQuery(float x0, float y0, float x1, float y1, float radius) {
+        float dx = x1 - x0;
+        float dy = y1 - y0;
+        float lengthSquared = dx * dx + dy * dy;
+        return { x0, y0, dx, dy, lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f, radius };
+    }
+
+    // Every kernel tests up to 64 circles and returns one bit per circle.
+    // With stopAtHit it returns as soon as a vector of circles has a hit, later bits are left clear.
+    // Swept kernels test against the segment; the point kernels skip the projection entirely.
+    using BlockKernel = uint64_t(*)(const float* x, const float* y, const float* r, size_t n, const Query& q, bool stopAtHit);
+
+    template <bool Swept>
+    uint64_t testBlockScalar(const float* x, const float* y, const float* r, size_t n, const Query& q, bool stopAtHit) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < n; i++) {
+            float dx = x[i] - q.ax;
+            float dy = y[i] - q.ay;
+            if constexpr (Swept) {
+                float t = (dx * q.dx + dy * q.dy) * q.inverseLengthSquared;
+                t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+                dx -= q.dx * t;
+                dy -= q.dy * t;
+            }
+            float reach = r[i] + q.radius;
+            if (dx * dx + dy * dy < reach * reach) {
+                mask |= (uint64_t)1 << i;
+                if (stopAtHit) break;
+            }
+        }
+        return mask;
+    }
+
+#ifdef CIRCLE_HIT_TEST_X86
+    template <bool Swept>
+    TARGET_SSE2 uint64_t testBlockSse2(const float* x, const float* y, const float* r, size_t n, const Query& q, bool stopAtHit) {
+        __m128 ax = _mm_set1_ps(q.ax);
+        __m128 ay = _mm_set1_ps(q.ay);
+        __m128 segmentX = _mm_set1_ps(q.dx);
+        __m128 segmentY = _mm_set1_ps(q.dy);
+        __m128 inverseLengthSquared = _mm_set1_ps(q.inverseLengthSquared);
+        __m128 radius = _mm_set1_ps(q.radius);
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+
+        uint64_t mask = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), ax);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), ay);
+            if constexpr (Swept) {
+                __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(dx, segmentX), _mm_mul_ps(dy, segmentY)), inverseLengthSquared);
+                t = _mm_min_ps(_mm_max_ps(t, zero), one);
+                dx = _mm_sub_ps(dx, _mm_mul_ps(segmentX, t));
+                dy = _mm_sub_ps(dy, _mm_mul_ps(segmentY, t));
+            }
+            __m128 reach = _mm_add_ps(_mm_loadu_ps(r + i), radius);
+            __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 hit = _mm_cmplt_ps(distance, _mm_mul_ps(reach, reach));
+            mask |= (uint64_t)(unsigned int)_mm_movemask_ps(hit) << i;
+            if (stopAtHit && mask) return mask;
+        }
+        if (i < n)
+            mask |= testBlockScalar<Swept>(x + i, y + i, r + i, n - i, q, stopAtHit) << i;
+        return mask;
+    }
+
+    template <bool Swept>
+    TARGET_AVX2 uint64_t testBlockAvx2(const float* x, const float* y, const float* r, size_t n, const Query& q, bool stopAtHit) {
+        __m256 ax = _mm256_set1_ps(q.ax);
+        __m256 ay = _mm256_set1_ps(q.ay);
+        __m256 segmentX = _mm256_set1_ps(q.dx);
+        __m256 segmentY = _mm256_set1_ps(q.dy);
+        __m256 inverseLengthSquared = _mm256_set1_ps(q.inverseLengthSquared);
+        __m256 radius = _mm256_set1_ps(q.radius);
+        __m256 zero = _mm256_setzero_ps();
+        __m256 one = _mm256_set1_ps(1.0f);
+
+        uint64_t mask = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), ax);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), ay);
+            if constexpr (Swept) {
+                __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(dx, segmentX), _mm256_mul_ps(dy, segmentY)), inverseLengthSquared);
+                t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+                dx = _mm256_sub_ps(dx, _mm256_mul_ps(segmentX, t));
+                dy = _mm256_sub_ps(dy, _mm256_mul_ps(segmentY, t));
+            }
+            __m256 reach = _mm256_add_ps(_mm256_loadu_ps(r + i), radius);
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 hit = _mm256_cmp_ps(distance, _mm256_mul_ps(reach, reach), _CMP_LT_OQ);
+            mask |= (uint64_t)(unsigned int)_mm256_movemask_ps(hit) << i;
+            if (stopAtHit && mask) return mask;
+        }
+        if (i < n)
+            mask |= testBlockScalar<Swept>(x + i, y + i, r + i, n - i, q, stopAtHit) << i;
+        return mask;
+    }
+#endif
+
+    CircleHitTest::Kernel detectKernel() {
+#ifdef CIRCLE_HIT_TEST_X86
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return CircleHitTest::Kernel::Avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return CircleHitTest::Kernel::Sse2;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        // AVX state must also be enabled by the OS, which is what OSXSAVE plus XCR0 tell us
+        bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        if (osAvx && maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5))
+                return CircleHitTest::Kernel::Avx2;
+        }
+        if (sse2)
+            return CircleHitTest::Kernel::Sse2;
+#endif
+#endif
+        return CircleHitTest::Kernel::Scalar;
+    }
+
+    CircleHitTest::Kernel supportedKernel() {
+        static const CircleHitTest::Kernel kernel = detectKernel();
+        return kernel;
+    }
+
+    std::atomic<int> activeKernel{ -1 };
+
+    template <bool Swept>
+    BlockKernel blockKernel(CircleHitTest::Kernel kernel) {
+        switch (kernel) {
+#ifdef CIRCLE_HIT_TEST_X86
+        case CircleHitTest::Kernel::Avx2: return testBlockAvx2<Swept>;
+        case CircleHitTest::Kernel::Sse2: return testBlockSse2<Swept>;
+#endif
+        default: return testBlockScalar<Swept>;
+        }
+    }
+
+    long long firstHitWith(BlockKernel kernel, const CircleArrays& circles, size_t first, size_t count, const Query& query) {
+        const float* cx = circles.x.data() + first;
+        const float* cy = circles.y.data() + first;
+        const float* cr = circles.radius.data() + first;
+
+        for (size_t block = 0; block < count; block += 64) {
+            size_t n = count - block < 64 ? count - block : 64;
+            uint64_t mask = kernel(cx + block, cy + block, cr + block, n, query, true);
+            if (mask)
+                return (long long)(block + std::countr_zero(mask));
+        }
+        return -1;
+    }
+
+    size_t hitMaskWith(BlockKernel kernel, const CircleArrays& circles, size_t first, size_t count, const Query& query,
+        std::vector<uint64_t>& mask) {
+        const float* cx = circles.x.data() + first;
+        const float* cy = circles.y.data() + first;
+        const float* cr = circles.radius.data() + first;
+
+        mask.resize((count + 63) / 64);
+        size_t hits = 0;
+        for (size_t word = 0; word < mask.size(); word++) {
+            size_t block = word * 64;
+            size_t n = count - block < 64 ? count - block : 64;
+            mask[word] = kernel(cx + block, cy + block, cr + block, n, query, false);
+            hits += std::popcount(mask[word]);
+        }
+        return hits;
+    }
+}
+
+CircleHitTest::Kernel CircleHitTest::getKernel() {
+    int kernel = activeKernel.load(std::memory_order_relaxed);
+    if (kernel < 0) {
+        kernel = (int)supportedKernel();
+        activeKernel.store(kernel, std::memory_order_relaxed);
+    }
+    return (Kernel)kernel;
+}
+
+void CircleHitTest::setKernel(Kernel kernel) {
+    Kernel supported = supportedKernel();
+    activeKernel.store((int)(kernel > supported ? supported : kernel), std::memory_order_relaxed);
+}
+
+const char* CircleHitTest::getKernelName(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Avx2: return "AVX2";
+    case Kernel::Sse2: return "SSE2";
+    default: return "Scalar";
+    }
+}
+
+long long CircleHitTest::firstHit(const CircleArrays& circles, size_t first, size_t count, float x, float y, float radius) {
+    return firstHitWith(blockKernel<false>(getKernel()), circles, first, count, makeQuery(x, y, x, y, radius));
+}
+
+size_t CircleHitTest::hitMask(const CircleArrays& circles, size_t first, size_t count, float x, float y, float radius,
+    std::vector<uint64_t>& mask) {
+    return hitMaskWith(blockKernel<false>(getKernel()), circles, first, count, makeQuery(x, y, x, y, radius), mask);
+}
+
+long long CircleHitTest::firstHit(const CircleArrays& circles, size_t first, size_t count, const Capsule& capsule) {
+    Query query = makeQuery(capsule.x0, capsule.y0, capsule.x1, capsule.y1, capsule.radius);
+    return firstHitWith(blockKernel<true>(getKernel()), circles, first, count, query);
+}
+
+size_t CircleHitTest::hitMask(const CircleArrays& circles, size_t first, size_t count, const Capsule& capsule,
+    std::vector<uint64_t>& mask) {
+    Query query = makeQuery(capsule.x0, capsule.y0, capsule.x1, capsule.y1, capsule.radius);
+    return hitMaskWith(blockKernel<true>(getKernel()), circles, first, count, query, mask);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Circle.h"
+
+// Circle centers and radii as separate arrays, so hit tests can load several circles per instruction.
+// Built once per stroke storage and shared by every slice of it, like the circles themselves.
+struct CircleArrays {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radius;
+
+    explicit CircleArrays(const std::vector<Circle>& circles);
+
+    size_t size() const { return x.size(); }
+
+    size_t memoryUsage() const { return (x.capacity() + y.capacity() + radius.capacity()) * sizeof(float); }
+};
+
+// Overlap tests of one query circle or capsule against a run of circles. Distances are compared squared
+// against the squared radius sum, so there is no sqrt. The widest kernel the CPU supports is
+// picked on first use: AVX2 (8 circles at a time), SSE2 (4) or plain scalar code.
+class CircleHitTest {
+public:
+    // What a circle of radius covers moving in a straight line from (x0, y0) to (x1, y1)
+    struct Capsule {
+        float x0, y0;
+        float x1, y1;
+        float radius;
+    };
+
+    enum class Kernel {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    static Kernel getKernel();
+
+    // Forces a narrower kernel, e.g. to compare them; one the CPU lacks falls back to the best available
+    static void setKernel(Kernel kernel);
+
+    static const char* getKernelName(Kernel kernel);
+
+    // Index of the first circle in [first, first + count) that overlaps (x, y, radius), relative to first, or -1
+    static long long firstHit(const CircleArrays& circles, size_t first, size_t count, float x, float y, float radius);
+
+    // Sets bit i of mask for every overlapping circle first + i, 64 circles per word; returns the number of hits
+    static size_t hitMask(const CircleArrays& circles, size_t first, size_t count, float x, float y, float radius,
+        std::vector<uint64_t>& mask);
+
+    // Same as above for a capsule, a circle overlaps it when it comes within its radius of the segment
+    static long long firstHit(const CircleArrays& circles, size_t first, size_t count, const Capsule& capsule);
+
+    static size_t hitMask(const CircleArrays& circles, size_t first, size_t count, const Capsule& capsule,
+        std::vector<uint64_t>& mask);
+};
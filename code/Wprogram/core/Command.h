@@ -1,6 +1,23 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+
 class Command {
+private:
+	// Commands currently alive anywhere; compare against the undo and redo stacks to spot leaks
+	inline static std::atomic<long long> liveCount{ 0 };
+
 public:
+	Command() { liveCount.fetch_add(1, std::memory_order_relaxed); }
+	Command(const Command&) { liveCount.fetch_add(1, std::memory_order_relaxed); }
+	Command& operator=(const Command&) = default;
+	virtual ~Command() { liveCount.fetch_sub(1, std::memory_order_relaxed); }
+
 	virtual void execute() = 0;
 	virtual void undo() = 0;
-};
\ No newline at end of file
+
+	// Heap bytes held by this command, including circle storage it shares with the board
+	virtual size_t getMemoryUsage() const = 0;
+
+	static long long getLiveCount() { return liveCount.load(std::memory_order_relaxed); }
+};
@@ -1,7 +1,7 @@
 #include "DrawCommand.h"
 
-DrawCommand::DrawCommand(std::vector<Circle>& cir, std::vector<float>& col, float size, std::vector<Stroke>* stRef)
-    : circles(cir), brushSize(size), strokes(stRef), strokeIndex(-1)
+DrawCommand::DrawCommand(std::vector<Circle>& cir, std::vector<float>& col, float size, BrushType btype, std::vector<Stroke>* stRef)
+    : circles(cir), brushSize(size), brush(btype), strokes(stRef), strokeIndex(-1)
 {
     color.resize(3);
     for (int i = 0; i < 3; i++) {
@@ -10,7 +10,7 @@ DrawCommand::DrawCommand(std::vector<Circle>& cir, std::vector<float>& col, floa
 }
 
 void DrawCommand::execute() {
-    Stroke newStroke(circles, color, brushSize);
+    Stroke newStroke(circles, color, brushSize, brush);
     strokes->push_back(newStroke);
     strokeIndex = strokes->size() - 1;
 }
@@ -18,4 +18,8 @@ void DrawCommand::execute() {
 void DrawCommand::undo() {
     if (strokeIndex >= 0 && strokeIndex < strokes->size()) 
         strokes->erase(strokes->begin() + strokeIndex);
+}
+
+size_t DrawCommand::getMemoryUsage() const {
+    return sizeof(*this) + circles.capacity() * sizeof(Circle) + color.capacity() * sizeof(float);
 }
\ No newline at end of file
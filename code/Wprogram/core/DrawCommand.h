@@ -9,13 +9,16 @@ private:
     std::vector<Circle> circles;
     std::vector<float> color;
     float brushSize;
+    BrushType brush;
     int strokeIndex;
     std::vector<Stroke>* strokes;
 
 public:
-    DrawCommand(std::vector<Circle>& cir, std::vector<float>& col, float size, std::vector<Stroke>* stRef);
+    DrawCommand(std::vector<Circle>& cir, std::vector<float>& col, float size, BrushType btype, std::vector<Stroke>* stRef);
 
     void execute() override;
 
     void undo() override;
+
+    size_t getMemoryUsage() const override;
 };
\ No newline at end of file
@@ -37,4 +37,11 @@ void EraseCommand::undo() {
     }
 
     wasExecuted = false;
+}
+
+size_t EraseCommand::getMemoryUsage() const {
+    size_t bytes = sizeof(*this) + strokeIndicesToRemove.capacity() * sizeof(int) + removedStrokes.capacity() * sizeof(Stroke);
+    for (const Stroke& stroke : removedStrokes)
+        bytes += stroke.ownBytes() + stroke.storageBytes();
+    return bytes;
 }
\ No newline at end of file
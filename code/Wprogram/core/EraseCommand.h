@@ -20,4 +20,6 @@ public:
 
     void undo() override;
 
+    size_t getMemoryUsage() const override;
+
 };
\ No newline at end of file
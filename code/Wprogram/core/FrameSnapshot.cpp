@@ -0,0 +1,44 @@
+#include "FrameSnapshot.h"
+
+FrameSnapshot::~FrameSnapshot() {
+    releaseUi();
+}
+
+void FrameSnapshot::captureUi(const ImDrawData* drawData) {
+    releaseUi();
+
+    for (ImDrawList* list : drawData->CmdLists) {
+        ImDrawList* clone = list->CloneOutput();
+        uiDrawLists.push_back(clone);
+        uiDrawData.CmdLists.push_back(clone);
+    }
+
+    uiDrawData.Valid = drawData->Valid;
+    uiDrawData.CmdListsCount = drawData->CmdListsCount;
+    uiDrawData.TotalIdxCount = drawData->TotalIdxCount;
+    uiDrawData.TotalVtxCount = drawData->TotalVtxCount;
+    uiDrawData.DisplayPos = drawData->DisplayPos;
+    uiDrawData.DisplaySize = drawData->DisplaySize;
+    uiDrawData.FramebufferScale = drawData->FramebufferScale;
+
+    // Texture requests mutate ImGui owned data, so they are only forwarded on synchronized frames
+    uiNeedsSync = false;
+    if (drawData->Textures != nullptr) {
+        for (ImTextureData* tex : *drawData->Textures) {
+            if (tex->Status != ImTextureStatus_OK) {
+                uiNeedsSync = true;
+                break;
+            }
+        }
+    }
+    uiDrawData.Textures = uiNeedsSync ? drawData->Textures : nullptr;
+}
+
+void FrameSnapshot::releaseUi() {
+    for (ImDrawList* list : uiDrawLists)
+        IM_DELETE(list);
+
+    uiDrawLists.clear();
+    uiDrawData.Clear();
+    uiNeedsSync = false;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "imgui.h"
+#include "BoardSnapshot.h"
+
+// Everything the render thread needs to produce one frame.
+struct FrameSnapshot {
+    unsigned long long frameIndex = 0;
+
+    BoardSnapshot board;
+
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    int sidebarWidth = 0;
+
+    // Cloned ImGui output, owned by this snapshot
+    ImDrawData uiDrawData;
+    std::vector<ImDrawList*> uiDrawLists;
+    // Set when ImGui has pending texture requests; the writer waits for this frame to be rendered
+    bool uiNeedsSync = false;
+
+    // Non-empty when the board should be saved right after it is rendered
+    std::string saveFilename;
+
+    FrameSnapshot() = default;
+    ~FrameSnapshot();
+
+    FrameSnapshot(const FrameSnapshot&) = delete;
+    FrameSnapshot& operator=(const FrameSnapshot&) = delete;
+
+    void captureUi(const ImDrawData* drawData);
+
+    void releaseUi();
+};
@@ -0,0 +1,71 @@
+#include "ImageImporter.h"
+#include "Profiler.h"
+#include "stb_image.h"
+
+ImageImporter::ImageImporter()
+    : stopping(false)
+{
+    worker = std::thread(&ImageImporter::run, this);
+}
+
+ImageImporter::~ImageImporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void ImageImporter::request(const std::string& path, float x, float y) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back({ path, x, y });
+    }
+    wake.notify_one();
+}
+
+bool ImageImporter::poll(Result& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (results.empty()) return false;
+
+    result = std::move(results.front());
+    results.pop_front();
+    return true;
+}
+
+void ImageImporter::run() {
+    Profiler::setThreadName("Image import");
+
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        Result result;
+        result.path = request.path;
+        result.x = request.x;
+        result.y = request.y;
+        result.width = 0;
+        result.height = 0;
+
+        // Flipping is left to the renderer, stbi's flip flag is global state
+        int channels = 0;
+        unsigned char* data;
+        {
+            PROFILE_ZONE("ImageImporter::decode");
+            data = stbi_load(request.path.c_str(), &result.width, &result.height, &channels, 4);
+        }
+        if (data)
+            result.pixels = std::shared_ptr<const unsigned char>(data, [](const unsigned char* p) { stbi_image_free((void*)p); });
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(std::move(result));
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Decodes image files on a worker thread so large pictures never stall input or rendering.
+// Requests are queued from the main thread and finished images are collected with poll().
+class ImageImporter {
+public:
+    struct Result {
+        std::string path;
+        // World position the image was dropped at
+        float x;
+        float y;
+        int width;
+        int height;
+        // RGBA8, top row first; null when the file could not be decoded
+        std::shared_ptr<const unsigned char> pixels;
+    };
+
+private:
+    struct Request {
+        std::string path;
+        float x;
+        float y;
+    };
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Request> requests;
+    std::deque<Result> results;
+    bool stopping;
+
+    void run();
+
+public:
+    ImageImporter();
+
+    ~ImageImporter();
+
+    ImageImporter(const ImageImporter&) = delete;
+    ImageImporter& operator=(const ImageImporter&) = delete;
+
+    void request(const std::string& path, float x, float y);
+
+    // Returns false when no decoded image is waiting
+    bool poll(Result& result);
+};
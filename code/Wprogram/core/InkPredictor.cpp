@@ -0,0 +1,67 @@
+#include "InkPredictor.h"
+
+void InkPredictor::predict(const std::vector<StrokeSample>& input, const glm::vec2& from, double now,
+    double horizon, float spacing, std::vector<glm::vec2>& points) {
+    if (input.empty() || horizon <= 0.0) return;
+
+    const StrokeSample& latest = input.back();
+    if (now - latest.time > horizon) return;
+
+    // Velocity over the newest and the previous interval inside the window
+    size_t first = input.size() - 1;
+    while (first > 0 && latest.time - input[first - 1].time <= HISTORY_WINDOW)
+        first--;
+
+    glm::vec2 velocity(0.0f);
+    glm::vec2 acceleration(0.0f);
+    size_t count = input.size() - first;
+    if (count >= 2) {
+        const StrokeSample& a = input[input.size() - 2];
+        float dt = (float)(latest.time - a.time);
+        if (dt > 0.0f)
+            velocity = (latest.position - a.position) / dt;
+    }
+    if (count >= 3) {
+        const StrokeSample& a = input[input.size() - 3];
+        const StrokeSample& b = input[input.size() - 2];
+        float dtPrevious = (float)(b.time - a.time);
+        float dt = (float)(latest.time - b.time);
+        if (dtPrevious > 0.0f && dt > 0.0f) {
+            glm::vec2 previousVelocity = (b.position - a.position) / dtPrevious;
+            acceleration = (velocity - previousVelocity) / ((dt + dtPrevious) * 0.5f) * ACCELERATION_WEIGHT;
+        }
+    }
+
+    // Path: the part the sampler has not emitted yet, then the extrapolation
+    std::vector<glm::vec2> path;
+    path.push_back(from);
+    path.push_back(latest.position);
+
+    float maxDistance = glm::length(velocity) * (float)horizon;
+    glm::vec2 previous = latest.position;
+    float travelled = 0.0f;
+    for (int i = 1; i <= PATH_STEPS && maxDistance > 0.0f; i++) {
+        float t = (float)horizon * i / PATH_STEPS;
+        glm::vec2 next = latest.position + velocity * t + 0.5f * acceleration * t * t;
+
+        // Never run further than constant velocity would, braking is fine
+        travelled += glm::length(next - previous);
+        if (travelled > maxDistance * 1.001f) break;
+        path.push_back(next);
+        previous = next;
+    }
+
+    // Resample at the stroke's spacing, starting one step after 'from'
+    float carried = 0.0f;
+    for (size_t i = 1; i < path.size(); i++) {
+        glm::vec2 start = path[i - 1];
+        glm::vec2 delta = path[i] - start;
+        float length = glm::length(delta);
+        float position = spacing - carried;
+        while (position <= length) {
+            points.push_back(start + delta * (position / length));
+            position += spacing;
+        }
+        carried = length - (position - spacing);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+#include "StrokeSampler.h"
+#include "glm/glm.hpp"
+
+// Extrapolates where the pen is heading from the velocity and acceleration of the
+// latest cursor samples. The result is a provisional tail for display only: it is
+// recomputed every frame and never becomes part of a stroke.
+class InkPredictor {
+private:
+    // Only this much recent input is used for the estimate, older motion is stale
+    static constexpr double HISTORY_WINDOW = 0.05;
+    // Acceleration is noisy, only part of it is trusted
+    static constexpr float ACCELERATION_WEIGHT = 0.5f;
+    static constexpr int PATH_STEPS = 8;
+
+public:
+    // Appends evenly spaced points from 'from' (the last committed-to-screen sample) through the
+    // latest cursor sample and on along the predicted path, horizon seconds past the latest sample.
+    // Nothing is predicted when the pen has been still for longer than the horizon.
+    static void predict(const std::vector<StrokeSample>& input, const glm::vec2& from, double now,
+        double horizon, float spacing, std::vector<glm::vec2>& points);
+};
@@ -0,0 +1,150 @@
+#include "InputRecording.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+    const char MAGIC[4] = { 'W', 'B', 'I', 'R' };
+    constexpr unsigned int VERSION = 1;
+
+    int payloadCount(InputAction::Type type) {
+        switch (type) {
+        case InputAction::Type::Press:
+        case InputAction::Type::Move:
+        case InputAction::Type::Release:
+            return 2;
+        case InputAction::Type::Color:
+            return 3;
+        case InputAction::Type::Mode:
+        case InputAction::Type::BrushSize:
+        case InputAction::Type::Brush:
+        case InputAction::Type::PartialErase:
+        case InputAction::Type::SimplifyStrokes:
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    // Files are little endian, as is every platform this builds for
+    template<typename T>
+    void write(std::ofstream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template<typename T>
+    bool read(std::ifstream& file, T& value) {
+        return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    }
+
+}
+
+InputRecorder::InputRecorder(double startTime, int framebufferWidth, int framebufferHeight)
+    : startTime(startTime), framebufferWidth(framebufferWidth), framebufferHeight(framebufferHeight)
+{
+}
+
+void InputRecorder::record(InputAction::Type type, double time, float a, float b, float c) {
+    actions.push_back({ type, time - startTime, { a, b, c } });
+}
+
+bool InputRecorder::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file.write(MAGIC, sizeof(MAGIC));
+    write<unsigned int>(file, VERSION);
+    write<int>(file, framebufferWidth);
+    write<int>(file, framebufferHeight);
+    write<unsigned long long>(file, actions.size());
+
+    for (const InputAction& action : actions) {
+        write<unsigned char>(file, (unsigned char)action.type);
+        write<unsigned int>(file, (unsigned int)std::max(action.time * 1e6, 0.0));
+        for (int i = 0; i < payloadCount(action.type); i++)
+            write<float>(file, action.values[i]);
+    }
+    return (bool)file;
+}
+
+InputReplay::InputReplay()
+    : cursor(0), realTime(false), startTime(0.0), framebufferWidth(0), framebufferHeight(0), lastFrame(-1.0)
+{
+}
+
+bool InputReplay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    char magic[4];
+    unsigned int version = 0;
+    unsigned long long count = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!read(file, version) || version != VERSION) return false;
+    if (!read(file, framebufferWidth) || !read(file, framebufferHeight) || !read(file, count)) return false;
+
+    actions.clear();
+    for (unsigned long long i = 0; i < count; i++) {
+        InputAction action = {};
+        unsigned char type;
+        unsigned int micros;
+        if (!read(file, type) || !read(file, micros) || type > (unsigned char)InputAction::Type::SimplifyStrokes) return false;
+
+        action.type = (InputAction::Type)type;
+        action.time = micros * 1e-6;
+        for (int v = 0; v < payloadCount(action.type); v++) {
+            if (!read(file, action.values[v])) return false;
+        }
+        actions.push_back(action);
+    }
+
+    cursor = 0;
+    return true;
+}
+
+void InputReplay::start(bool realTimeReplay, double now) {
+    realTime = realTimeReplay;
+    startTime = now;
+    cursor = 0;
+    lastFrame = -1.0;
+    frameTimes.clear();
+}
+
+void InputReplay::nextFrame(double now, std::vector<InputAction>& due) {
+    if (lastFrame >= 0.0 && !finished())
+        frameTimes.push_back((now - lastFrame) * 1000.0);
+    lastFrame = now;
+
+    while (cursor < actions.size()) {
+        const InputAction& action = actions[cursor];
+        if (realTime && toClock(action.time) > now) break;
+
+        cursor++;
+        if (action.type == InputAction::Type::Frame) {
+            if (!realTime) break;
+            continue;
+        }
+        due.push_back(action);
+    }
+}
+
+InputReplay::FrameTimes InputReplay::summarizeFrameTimes() const {
+    FrameTimes summary;
+    if (frameTimes.empty()) return summary;
+
+    std::vector<double> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&](double p) { return sorted[(size_t)(p * (sorted.size() - 1) + 0.5)]; };
+
+    summary.frames = sorted.size();
+    for (double value : sorted)
+        summary.mean += value;
+    summary.mean /= sorted.size();
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = sorted.back();
+    return summary;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// One entry of a recorded session: a pointer event, a frame boundary or a UI action
+struct InputAction {
+    enum class Type : unsigned char {
+        Press,
+        Move,
+        Release,
+        // The events before this one were applied together in one frame
+        Frame,
+        Mode,
+        Color,
+        BrushSize,
+        Brush,
+        PartialErase,
+        Undo,
+        Redo,
+        Clear,
+        // Added after Clear so existing recordings keep their type values
+        SimplifyStrokes
+    };
+
+    Type type;
+    // Seconds since the recording started
+    double time;
+    // Pointer: window x, y. Color: r, g, b. BrushSize: size. Mode, Brush, PartialErase, SimplifyStrokes: the value as a number
+    float values[3];
+};
+
+// Captures a session in memory and writes it as a compact binary file:
+// a header with the framebuffer size, then per action a type byte, a microsecond
+// time offset and only the payload floats that type uses.
+class InputRecorder {
+private:
+    std::vector<InputAction> actions;
+    double startTime;
+    int framebufferWidth;
+    int framebufferHeight;
+
+public:
+    InputRecorder(double startTime, int framebufferWidth, int framebufferHeight);
+
+    // time is on the PointerInput clock
+    void record(InputAction::Type type, double time, float a = 0.0f, float b = 0.0f, float c = 0.0f);
+
+    size_t size() const { return actions.size(); }
+
+    bool save(const std::string& path) const;
+};
+
+// Feeds a recorded session back, either as fast as frames can be produced (one recorded
+// frame per frame, so batching matches the recording exactly) or at the recorded pace.
+class InputReplay {
+public:
+    struct FrameTimes {
+        size_t frames = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+private:
+    std::vector<InputAction> actions;
+    size_t cursor;
+    bool realTime;
+    double startTime;
+    int framebufferWidth;
+    int framebufferHeight;
+
+    double lastFrame;
+    std::vector<double> frameTimes;
+
+public:
+    InputReplay();
+
+    bool load(const std::string& path);
+
+    // now is on the PointerInput clock, the first call starts the clock of a real-time replay
+    void start(bool realTime, double now);
+
+    // Appends the actions due this frame and records the time since the previous call
+    void nextFrame(double now, std::vector<InputAction>& due);
+
+    bool finished() const { return cursor >= actions.size(); }
+
+    // Start time plus the recorded offset, for pointer event timestamps
+    double toClock(double recordedTime) const { return startTime + recordedTime; }
+
+    // Framebuffer size at record time; pointer positions are mapped with it so the board matches
+    int getFramebufferWidth() const { return framebufferWidth; }
+    int getFramebufferHeight() const { return framebufferHeight; }
+
+    size_t size() const { return actions.size(); }
+
+    // Frame intervals in milliseconds over the replay so far
+    FrameTimes summarizeFrameTimes() const;
+};
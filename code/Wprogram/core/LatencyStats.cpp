@@ -0,0 +1,68 @@
+#include "LatencyStats.h"
+#include <algorithm>
+#include <fstream>
+
+LatencyStats::LatencyStats()
+    : next(0)
+{
+    samples.reserve(WINDOW);
+}
+
+void LatencyStats::record(unsigned long long frameId, double inputTime, double presentTime) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Sample sample = { frameId, inputTime, presentTime };
+    if (samples.size() < WINDOW)
+        samples.push_back(sample);
+    else
+        samples[next] = sample;
+    next = (next + 1) % WINDOW;
+}
+
+LatencyStats::Summary LatencyStats::summarize() const {
+    std::vector<double> latencies;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        latencies.reserve(samples.size());
+        for (const Sample& sample : samples)
+            latencies.push_back((sample.presentTime - sample.inputTime) * 1000.0);
+    }
+
+    Summary summary;
+    summary.count = latencies.size();
+    if (latencies.empty()) return summary;
+
+    // Nearest-rank percentiles
+    auto percentile = [&](double p) {
+        size_t rank = (size_t)(p * (latencies.size() - 1) + 0.5);
+        std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+        return latencies[rank];
+    };
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    return summary;
+}
+
+bool LatencyStats::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file << "frame,input_time_s,present_time_s,latency_ms\n";
+
+    size_t first = samples.size() < WINDOW ? 0 : next;
+    for (size_t i = 0; i < samples.size(); i++) {
+        const Sample& sample = samples[(first + i) % samples.size()];
+        file << sample.frameId << ','
+            << std::fixed << sample.inputTime << ',' << sample.presentTime << ','
+            << (sample.presentTime - sample.inputTime) * 1000.0 << '\n';
+    }
+    return (bool)file;
+}
+
+void LatencyStats::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    samples.clear();
+    next = 0;
+}
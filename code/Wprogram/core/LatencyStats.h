@@ -0,0 +1,44 @@
+#pragma once
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Rolling window of input-to-display latencies.
+// Written by the render thread as frames are confirmed, read by the UI on the main thread.
+class LatencyStats {
+public:
+    struct Sample {
+        unsigned long long frameId;
+        // PointerInput clock, seconds
+        double inputTime;
+        double presentTime;
+    };
+
+    struct Summary {
+        size_t count = 0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+    };
+
+private:
+    static constexpr size_t WINDOW = 4096;
+
+    mutable std::mutex mutex;
+    // Ring of the newest WINDOW samples, next is where the next one goes
+    std::vector<Sample> samples;
+    size_t next;
+
+public:
+    LatencyStats();
+
+    void record(unsigned long long frameId, double inputTime, double presentTime);
+
+    // Percentiles in milliseconds over the current window
+    Summary summarize() const;
+
+    // One row per sample in the window, oldest first; returns false when the file cannot be written
+    bool writeCsv(const std::string& path) const;
+
+    void clear();
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include "Circle.h"
+
+// Append-only circle storage for the stroke being drawn.
+// Circles live in fixed-size chunks and never move once written, so the render
+// thread can read the first N circles of a snapshot while the input thread appends.
+class LiveStroke {
+private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+    static constexpr size_t MAX_CHUNKS = 4096;
+
+    std::unique_ptr<Circle*[]> chunks;
+    size_t count;
+
+public:
+    LiveStroke() : chunks(new Circle*[MAX_CHUNKS]()), count(0) {}
+
+    ~LiveStroke() {
+        for (size_t i = 0; i < MAX_CHUNKS && chunks[i]; i++)
+            ::operator delete(chunks[i]);
+    }
+
+    LiveStroke(const LiveStroke&) = delete;
+    LiveStroke& operator=(const LiveStroke&) = delete;
+
+    bool append(const Circle& circle) {
+        size_t chunk = count / CHUNK_SIZE;
+        if (chunk >= MAX_CHUNKS) return false;
+
+        if (!chunks[chunk])
+            chunks[chunk] = static_cast<Circle*>(::operator new(CHUNK_SIZE * sizeof(Circle)));
+
+        new (&chunks[chunk][count % CHUNK_SIZE]) Circle(circle);
+        count++;
+        return true;
+    }
+
+    size_t size() const { return count; }
+
+    // The chunk table plus every chunk allocated so far
+    size_t memoryUsage() const {
+        size_t allocatedChunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        return MAX_CHUNKS * sizeof(Circle*) + allocatedChunks * CHUNK_SIZE * sizeof(Circle);
+    }
+
+    const Circle& operator[](size_t index) const {
+        return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Heap bytes held by the board model, split by what holds them.
+// Figures come from container capacities, allocator overhead is not included.
+struct BoardMemoryUsage {
+    // Circle storage behind the committed strokes, each shared storage counted once
+    size_t strokeStorage = 0;
+    // The stroke list itself and per-stroke data
+    size_t strokes = 0;
+    // Circles of the stroke being drawn, before it is committed
+    size_t tempCircles = 0;
+    // Chunks the render thread reads the stroke being drawn from
+    size_t liveStroke = 0;
+    // Sampler output, raw input history, pending latency times and the predicted tail
+    size_t input = 0;
+    // Bookkeeping of the current erase gesture
+    size_t eraser = 0;
+    // Decoded pixels of placed images
+    size_t images = 0;
+
+    size_t total() const {
+        return strokeStorage + strokes + tempCircles + liveStroke + input + eraser + images;
+    }
+};
+
+template <typename T>
+size_t vectorBytes(const std::vector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
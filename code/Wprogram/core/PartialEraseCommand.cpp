@@ -0,0 +1,75 @@
+#include "PartialEraseCommand.h"
+#include <algorithm>
+
+PartialEraseCommand::PartialEraseCommand(std::vector<std::pair<int, unsigned int>> erasedCircles, std::vector<Stroke>* strokesRef)
+    : strokes(strokesRef), wasExecuted(false)
+{
+    std::sort(erasedCircles.begin(), erasedCircles.end());
+    erasedCircles.erase(std::unique(erasedCircles.begin(), erasedCircles.end()), erasedCircles.end());
+
+    // Walk the erased circles stroke by stroke; the gaps between them are the pieces that remain
+    size_t i = 0;
+    while (i < erasedCircles.size()) {
+        int strokeIndex = erasedCircles[i].first;
+        if (strokeIndex < 0 || strokeIndex >= (int)strokes->size()) {
+            i++;
+            continue;
+        }
+
+        const Stroke& stroke = (*strokes)[strokeIndex];
+        Split split{ strokeIndex, stroke, {} };
+
+        unsigned int runStart = 0;
+        for (; i < erasedCircles.size() && erasedCircles[i].first == strokeIndex; i++) {
+            unsigned int erased = erasedCircles[i].second;
+            if (erased >= stroke.size()) continue;
+
+            if (erased > runStart)
+                split.pieces.push_back({ runStart, erased - runStart });
+            runStart = erased + 1;
+        }
+        if (runStart < stroke.size())
+            split.pieces.push_back({ runStart, stroke.size() - runStart });
+
+        splits.push_back(std::move(split));
+    }
+}
+
+void PartialEraseCommand::execute() {
+    if (wasExecuted) return;
+
+    // Back to front so earlier stroke indices stay valid
+    for (auto it = splits.rbegin(); it != splits.rend(); ++it) {
+        std::vector<Stroke> pieces;
+        pieces.reserve(it->pieces.size());
+        for (const auto& piece : it->pieces)
+            pieces.emplace_back(it->original, piece.first, piece.second);
+
+        strokes->erase(strokes->begin() + it->strokeIndex);
+        strokes->insert(strokes->begin() + it->strokeIndex, pieces.begin(), pieces.end());
+    }
+
+    wasExecuted = true;
+}
+
+void PartialEraseCommand::undo() {
+    if (!wasExecuted) return;
+
+    // Front to back: once earlier splits are undone, this split's pieces start at its original index
+    for (const Split& split : splits) {
+        auto first = strokes->begin() + split.strokeIndex;
+        strokes->erase(first, first + split.pieces.size());
+        strokes->insert(strokes->begin() + split.strokeIndex, split.original);
+    }
+
+    wasExecuted = false;
+}
+
+size_t PartialEraseCommand::getMemoryUsage() const {
+    // The pieces are views into the original storage, which is counted once per split
+    size_t bytes = sizeof(*this) + splits.capacity() * sizeof(Split);
+    for (const Split& split : splits)
+        bytes += split.original.ownBytes() + split.original.storageBytes()
+            + split.pieces.capacity() * sizeof(split.pieces[0]);
+    return bytes;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Command.h"
+#include "Stroke.h"
+#include <vector>
+#include <utility>
+
+// Erases individual circles by splitting strokes into the runs that survive.
+// The pieces are views into the original circle storage, so neither doing nor
+// undoing the split copies any circles; only the run boundaries are recorded.
+class PartialEraseCommand : public Command {
+private:
+    struct Split {
+        int strokeIndex;
+        Stroke original;
+        // Surviving runs as (first, count), relative to the original stroke
+        std::vector<std::pair<unsigned int, unsigned int>> pieces;
+    };
+
+    // Sorted by ascending stroke index
+    std::vector<Split> splits;
+    std::vector<Stroke>* strokes;
+    bool wasExecuted;
+
+public:
+    // erasedCircles holds (stroke index, circle index) pairs, duplicates are allowed
+    PartialEraseCommand(std::vector<std::pair<int, unsigned int>> erasedCircles, std::vector<Stroke>* strokesRef);
+
+    void execute() override;
+
+    void undo() override;
+
+    size_t getMemoryUsage() const override;
+
+    bool empty() const { return splits.empty(); }
+};
@@ -0,0 +1,32 @@
+#include "PointerInput.h"
+#include <chrono>
+
+PointerInput::PointerInput()
+    : buttonDown(false), lastX(0.0), lastY(0.0), overflowed(0)
+{
+}
+
+double PointerInput::now() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void PointerInput::push(PointerEvent::Type type, double x, double y) {
+    if (type == PointerEvent::Type::Move) {
+        if (!buttonDown || (x == lastX && y == lastY)) return;
+    }
+    else {
+        buttonDown = type == PointerEvent::Type::Press;
+    }
+    lastX = x;
+    lastY = y;
+
+    if (!queue.push({ type, x, y, now() }))
+        overflowed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PointerInput::drain(std::vector<PointerEvent>& events) {
+    PointerEvent event;
+    while (queue.pop(event))
+        events.push_back(event);
+}
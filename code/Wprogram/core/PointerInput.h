@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include "SpscQueue.h"
+
+struct PointerEvent {
+    enum class Type {
+        Press,
+        Move,
+        Release
+    };
+
+    Type type;
+    // Window coordinates as reported by GLFW
+    double x, y;
+    // Seconds on the monotonic input clock
+    double time;
+};
+
+// Pointer events recorded by the GLFW callbacks and drained once per frame.
+// Callbacks only timestamp and enqueue; all whiteboard work happens in the drain,
+// so the cost of a burst of events is paid once per frame instead of per event.
+class PointerInput {
+private:
+    static constexpr size_t QUEUE_CAPACITY = 1 << 14;
+
+    SpscQueue<PointerEvent, QUEUE_CAPACITY> queue;
+
+    // Producer side: moves with the button up are never queued, repeated positions are folded
+    bool buttonDown;
+    double lastX, lastY;
+
+    std::atomic<unsigned long long> overflowed;
+
+    void push(PointerEvent::Type type, double x, double y);
+
+public:
+    PointerInput();
+
+    static double now();
+
+    void press(double x, double y) { push(PointerEvent::Type::Press, x, y); }
+
+    void move(double x, double y) { push(PointerEvent::Type::Move, x, y); }
+
+    void release(double x, double y) { push(PointerEvent::Type::Release, x, y); }
+
+    // Appends every event queued since the last call, in arrival order
+    void drain(std::vector<PointerEvent>& events);
+
+    // Events lost because the queue was full, should stay zero
+    unsigned long long getOverflowed() const { return overflowed.load(std::memory_order_relaxed); }
+};
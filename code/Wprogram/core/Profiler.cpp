@@ -0,0 +1,116 @@
+#include "Profiler.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+    struct Zone {
+        const char* name;
+        unsigned long long start;
+        unsigned long long end;
+    };
+
+    // Written only by its own thread; head is published after the slot is filled
+    struct ThreadBuffer {
+        static constexpr size_t CAPACITY = 1 << 15;
+
+        Zone zones[CAPACITY];
+        std::atomic<size_t> head{ 0 };
+        unsigned int id = 0;
+        std::string name;
+    };
+
+    std::mutex registryMutex;
+    // Buffers outlive their threads so a trace can still include them
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+    ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(std::make_unique<ThreadBuffer>());
+            buffer = registry.back().get();
+            buffer->id = (unsigned int)registry.size();
+            buffer->name = "Thread " + std::to_string(buffer->id);
+        }
+        return *buffer;
+    }
+
+    void writeEscaped(std::ofstream& file, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') file << '\\';
+            file << c;
+        }
+    }
+
+}
+
+std::atomic<bool> Profiler::enabledFlag{ false };
+
+void Profiler::setThreadName(const char* name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+unsigned long long Profiler::now() {
+    using namespace std::chrono;
+    return (unsigned long long)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char* name, unsigned long long start, unsigned long long end) {
+    ThreadBuffer& buffer = threadBuffer();
+    size_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.zones[head % ThreadBuffer::CAPACITY] = { name, start, end };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path, double windowSeconds) {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    unsigned long long from = now() - (unsigned long long)(windowSeconds * 1e9);
+    std::vector<Zone> zones;
+    bool first = true;
+
+    // Timestamps are in microseconds, keep nanosecond resolution
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry) {
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":\"";
+        writeEscaped(file, buffer->name);
+        file << "\"}}";
+        first = false;
+
+        // The owning thread keeps recording, slots it may have overwritten while they were copied are dropped
+        size_t head = buffer->head.load(std::memory_order_acquire);
+        size_t begin = head > ThreadBuffer::CAPACITY ? head - ThreadBuffer::CAPACITY : 0;
+        zones.clear();
+        for (size_t i = begin; i < head; i++)
+            zones.push_back(buffer->zones[i % ThreadBuffer::CAPACITY]);
+
+        size_t headAfter = buffer->head.load(std::memory_order_acquire);
+        size_t overwritten = headAfter > ThreadBuffer::CAPACITY ? headAfter - ThreadBuffer::CAPACITY : 0;
+
+        for (size_t i = 0; i < zones.size(); i++) {
+            const Zone& zone = zones[i];
+            if (begin + i < overwritten || zone.start < from) continue;
+
+            file << ",\n{\"name\":\"";
+            writeEscaped(file, zone.name);
+            file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << zone.start / 1000.0
+                << ",\"dur\":" << (zone.end - zone.start) / 1000.0 << "}";
+        }
+    }
+
+    file << "\n]}\n";
+    return (bool)file;
+}
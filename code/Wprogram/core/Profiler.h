@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+// Scoped CPU timing zones for the hot paths.
+// Each thread records into its own ring, so zones never contend; while profiling is off
+// a zone costs one relaxed atomic load. A capture window can be written out as Chrome
+// trace-event JSON and opened in Perfetto or chrome://tracing.
+class Profiler {
+public:
+    static void setEnabled(bool enabled) { enabledFlag.store(enabled, std::memory_order_relaxed); }
+
+    static bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+
+    // Shown as the track name in the trace, call once at thread start
+    static void setThreadName(const char* name);
+
+    // Nanoseconds on the steady clock
+    static unsigned long long now();
+
+    // name must outlive the profiler, in practice a string literal
+    static void record(const char* name, unsigned long long start, unsigned long long end);
+
+    // Writes the zones that started in the last windowSeconds; returns false when the file cannot be written
+    static bool writeChromeTrace(const std::string& path, double windowSeconds);
+
+private:
+    static std::atomic<bool> enabledFlag;
+};
+
+class ProfileZone {
+private:
+    const char* name;
+    unsigned long long start;
+
+public:
+    explicit ProfileZone(const char* name)
+        : name(name), start(Profiler::isEnabled() ? Profiler::now() : 0)
+    {
+    }
+
+    ~ProfileZone() {
+        if (start != 0)
+            Profiler::record(name, start, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
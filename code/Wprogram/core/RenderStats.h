@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include "GpuProfiler.h"
+
+// Rolling per-frame readout of the render thread, copied to the UI on the main thread.
+struct RenderStats {
+    static constexpr int HISTORY = 120;
+    static constexpr int MAX_PASSES = 8;
+
+    // Each history is a ring, historyOffset is the oldest entry as expected by ImGui::PlotLines
+    float cpuFrameMs[HISTORY] = {};
+    const char* passNames[MAX_PASSES] = {};
+    float passMs[MAX_PASSES][HISTORY] = {};
+    int passCount = 0;
+    int historyOffset = 0;
+
+    unsigned long long drawCalls = 0;
+    size_t circles = 0;
+    // GL state changes made in the frame and the redundant ones the Renderer's shadow state skipped
+    unsigned long long stateChangesIssued = 0;
+    unsigned long long stateChangesSkipped = 0;
+
+    void push(double cpuMs, const std::vector<GpuPassTiming>& passes, unsigned long long frameDrawCalls, size_t frameCircles,
+        unsigned long long frameStateChangesIssued, unsigned long long frameStateChangesSkipped) {
+        cpuFrameMs[historyOffset] = (float)cpuMs;
+        for (int i = 0; i < passCount; i++)
+            passMs[i][historyOffset] = 0.0f;
+
+        // Passes are matched by name so a skipped pass does not shift the others
+        for (const GpuPassTiming& pass : passes) {
+            int index = 0;
+            while (index < passCount && passNames[index] != pass.Name)
+                index++;
+            if (index == passCount) {
+                if (passCount == MAX_PASSES) continue;
+                passNames[passCount++] = pass.Name;
+            }
+            passMs[index][historyOffset] = (float)pass.Milliseconds;
+        }
+
+        historyOffset = (historyOffset + 1) % HISTORY;
+        drawCalls = frameDrawCalls;
+        circles = frameCircles;
+        stateChangesIssued = frameStateChangesIssued;
+        stateChangesSkipped = frameStateChangesSkipped;
+    }
+};
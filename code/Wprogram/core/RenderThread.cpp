@@ -0,0 +1,170 @@
+#include "RenderThread.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <chrono>
+#include "imgui_impl_opengl3.h"
+#include "BoardRenderer.h"
+#include "GLExtensions.h"
+#include "PresentTimer.h"
+#include "PointerInput.h"
+#include "Profiler.h"
+#include <deque>
+
+RenderThread::RenderThread(GLFWwindow* window)
+    : window(window), running(false), renderedFrame(0), nextFrameIndex(1)
+{
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start() {
+    if (running) return true;
+
+    // The context moves to the render thread for the rest of the program
+    glfwMakeContextCurrent(nullptr);
+
+    std::promise<bool> ready;
+    std::future<bool> initialized = ready.get_future();
+
+    running = true;
+    thread = std::thread(&RenderThread::run, this, std::move(ready));
+
+    if (!initialized.get()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void RenderThread::stop() {
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+FrameSnapshot& RenderThread::beginFrame() {
+    FrameSnapshot& frame = frames.getWriteBuffer();
+    frame.frameIndex = nextFrameIndex++;
+    frame.saveFilename.clear();
+    return frame;
+}
+
+void RenderThread::publishFrame() {
+    FrameSnapshot& frame = frames.getWriteBuffer();
+    unsigned long long frameIndex = frame.frameIndex;
+    bool needsSync = frame.uiNeedsSync;
+
+    frames.publish();
+
+    // ImGui texture uploads touch data owned by the ImGui context,
+    // so the main thread waits until the render thread has applied them
+    if (needsSync) {
+        while (running && renderedFrame.load(std::memory_order_acquire) < frameIndex)
+            std::this_thread::yield();
+    }
+}
+
+void RenderThread::run(std::promise<bool> ready) {
+    Profiler::setThreadName("Render");
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGL()) {
+        std::cerr << "Failed to load OpenGL on the render thread" << std::endl;
+        glfwMakeContextCurrent(nullptr);
+        ready.set_value(false);
+        return;
+    }
+    glfwSwapInterval(1);
+    LoadGLExtensions();
+    GLInitDebugOutput();
+
+    {
+        BoardRenderer boardRenderer;
+
+        GpuProfiler gpuProfiler;
+        Renderer& renderer = Renderer::getInstance();
+
+        PresentTimer presentTimer;
+        // Frames carrying new input, waiting for their present time
+        std::deque<std::pair<unsigned long long, std::vector<double>>> timedFrames;
+        std::vector<PresentTimer::Result> presented;
+
+        auto recordLatency = [&]() {
+            presented.clear();
+            presentTimer.Poll(PointerInput::now(), presented);
+            for (const PresentTimer::Result& result : presented) {
+                while (!timedFrames.empty() && timedFrames.front().first <= result.FrameId) {
+                    if (timedFrames.front().first == result.FrameId) {
+                        for (double inputTime : timedFrames.front().second)
+                            latency.record(result.FrameId, inputTime, result.PresentTime);
+                    }
+                    timedFrames.pop_front();
+                }
+            }
+        };
+
+        ImGui_ImplOpenGL3_Init("#version 330");
+        ImGui_ImplOpenGL3_NewFrame();
+
+        ready.set_value(true);
+
+        while (running) {
+            if (!frames.consume()) {
+                recordLatency();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            FrameSnapshot& frame = frames.getReadBuffer();
+            PROFILE_ZONE("RenderThread::frame");
+            auto frameStart = std::chrono::steady_clock::now();
+            gpuProfiler.BeginFrame();
+            renderer.ResetBatchStats();
+            renderer.ResetStateChangeStats();
+
+            GLCall(glViewport(frame.sidebarWidth, 0, frame.framebufferWidth - frame.sidebarWidth, frame.framebufferHeight));
+            GLCall(glClearColor(1.0f, 1.0f, 1.0f, 1.0f));
+            boardRenderer.render(frame.board, glm::vec4(frame.sidebarWidth, 0, frame.framebufferWidth - frame.sidebarWidth, frame.framebufferHeight), &gpuProfiler);
+
+            if (!frame.saveFilename.empty()) {
+                bool success = boardRenderer.saveDrawing(frame.saveFilename, frame.sidebarWidth, frame.framebufferWidth, frame.framebufferHeight);
+
+                if (!success)
+                    std::cerr << "Failed to save the image" << std::endl;
+            }
+
+            GLCall(glViewport(0, 0, frame.framebufferWidth, frame.framebufferHeight));
+            gpuProfiler.BeginPass("ImGui");
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplOpenGL3_RenderDrawData(&frame.uiDrawData);
+            gpuProfiler.EndPass();
+            // The ImGui backend binds GL objects behind the Renderer's back
+            renderer.InvalidateState();
+
+            // Swap is left out, it mostly waits for vsync
+            {
+                double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+                std::lock_guard<std::mutex> lock(statsMutex);
+                const StateChangeStats& stateChanges = renderer.GetStateChangeStats();
+                stats.push(cpuMs, gpuProfiler.GetResults(), renderer.GetBatchStats().DrawCalls, boardRenderer.getDrawnCircles(),
+                    stateChanges.Issued, stateChanges.Skipped);
+            }
+
+            glfwSwapBuffers(window);
+
+            if (!frame.board.inputTimes.empty()) {
+                presentTimer.Mark(frame.frameIndex);
+                timedFrames.push_back({ frame.frameIndex, frame.board.inputTimes });
+            }
+            recordLatency();
+
+            renderedFrame.store(frame.frameIndex, std::memory_order_release);
+        }
+
+        ImGui_ImplOpenGL3_Shutdown();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
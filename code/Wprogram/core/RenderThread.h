@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <future>
+#include <mutex>
+#include "TripleBuffer.h"
+#include "FrameSnapshot.h"
+#include "LatencyStats.h"
+#include "RenderStats.h"
+
+struct GLFWwindow;
+
+// Owns the GL context of the window and draws the most recent published frame.
+// Input handling and command execution stay on the main thread; the two sides
+// only meet through the lock-free triple buffer of frame snapshots.
+class RenderThread {
+private:
+    GLFWwindow* window;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<unsigned long long> renderedFrame;
+    unsigned long long nextFrameIndex;
+
+    TripleBuffer<FrameSnapshot> frames;
+
+    LatencyStats latency;
+
+    mutable std::mutex statsMutex;
+    RenderStats stats;
+
+    void run(std::promise<bool> ready);
+
+public:
+    RenderThread(GLFWwindow* window);
+
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // Must be called from the main thread after the ImGui context is created and before the first ImGui frame
+    bool start();
+
+    void stop();
+
+    // True when the render thread picked up the last published frame and is ready for a new one
+    bool readyForFrame() const { return !frames.hasPending(); }
+
+    FrameSnapshot& beginFrame();
+
+    void publishFrame();
+
+    // Input-to-display latency of the live stroke, safe to read from the main thread
+    LatencyStats& getLatencyStats() { return latency; }
+
+    // Copy of the frame timings, GPU passes lag a few frames behind
+    RenderStats getRenderStats() const {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        return stats;
+    }
+};
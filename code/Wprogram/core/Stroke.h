@@ -1,19 +1,77 @@
 #pragma once
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <cfloat>
 #include "Circle.h"
+#include "Brush.h"
+#include "CircleHitTest.h"
 
 struct Stroke {
 public:
-    std::vector<Circle> circles;
+    // Circles are shared by every stroke split from the same original stroke;
+    // this stroke is the [offset, offset + count) slice of that storage
+    std::shared_ptr<const std::vector<Circle>> storage;
+    // The same circles laid out for the hit-test kernels, shared the same way
+    std::shared_ptr<const CircleArrays> arrays;
+    unsigned int offset;
+    unsigned int count;
     std::vector<float> color;
     float brushSize;
+    BrushType brush;
+    // Bounds of the circles including their radii, so hit tests can skip the stroke early.
+    // Slices keep the bounds of the stroke they were cut from: still valid for rejection,
+    // and splitting never has to walk the circles.
+    float minX, minY, maxX, maxY;
 
-    Stroke(std::vector<Circle>& cir, std::vector<float>& col, float bsize)
-        : circles(cir), brushSize(bsize)
+    Stroke(std::vector<Circle>& cir, std::vector<float>& col, float bsize, BrushType btype = BrushType::Round)
+        : storage(std::make_shared<const std::vector<Circle>>(cir)), arrays(std::make_shared<const CircleArrays>(cir)), offset(0), count(cir.size()), brushSize(bsize), brush(btype)
     {
         color.resize(3);
         for (int i = 0; i < 3; i++) {
             color[i] = col[i];
         }
+        computeBounds();
+    }
+
+    // A slice of another stroke, sharing its circles; first is relative to the source slice
+    Stroke(const Stroke& source, unsigned int first, unsigned int n)
+        : storage(source.storage), arrays(source.arrays), offset(source.offset + first), count(n),
+        color(source.color), brushSize(source.brushSize), brush(source.brush),
+        minX(source.minX), minY(source.minY), maxX(source.maxX), maxY(source.maxY)
+    {
+    }
+
+    Stroke(const Stroke&) = default;
+    Stroke& operator=(const Stroke&) = default;
+
+    unsigned int size() const { return count; }
+
+    const Circle& operator[](unsigned int index) const { return (*storage)[offset + index]; }
+
+    const Circle* begin() const { return storage->data() + offset; }
+    const Circle* end() const { return storage->data() + offset + count; }
+
+    // Heap bytes of the whole shared circle storage, not just this slice
+    size_t storageBytes() const { return storage->capacity() * sizeof(Circle) + arrays->memoryUsage(); }
+
+    // Heap bytes owned by this stroke alone
+    size_t ownBytes() const { return color.capacity() * sizeof(float); }
+
+    bool boundsOverlap(float left, float bottom, float right, float top) const {
+        return minX <= right && maxX >= left && minY <= top && maxY >= bottom;
+    }
+
+private:
+    // An empty stroke gets inverted bounds, which overlap nothing
+    void computeBounds() {
+        minX = minY = FLT_MAX;
+        maxX = maxY = -FLT_MAX;
+        for (const Circle& circle : *this) {
+            minX = std::min(minX, circle.centerX - circle.raduis);
+            minY = std::min(minY, circle.centerY - circle.raduis);
+            maxX = std::max(maxX, circle.centerX + circle.raduis);
+            maxY = std::max(maxY, circle.centerY + circle.raduis);
+        }
     }
 };
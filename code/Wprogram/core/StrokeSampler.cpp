@@ -0,0 +1,103 @@
+#include "StrokeSampler.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+    glm::vec2 catmullRom(const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, float t) {
+        float t2 = t * t;
+        float t3 = t2 * t;
+        return 0.5f * ((2.0f * p1)
+            + (p2 - p0) * t
+            + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+            + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+    }
+
+    // Angle between the incoming and outgoing directions at b
+    float turnAngle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+        glm::vec2 in = b - a;
+        glm::vec2 out = c - b;
+        float lengths = glm::length(in) * glm::length(out);
+        if (lengths <= 0.0f) return 0.0f;
+        return std::acos(std::clamp(glm::dot(in, out) / lengths, -1.0f, 1.0f));
+    }
+
+}
+
+StrokeSampler::StrokeSampler()
+    : pointCount(0), spacing(0.01f), carried(0.0f)
+{
+}
+
+void StrokeSampler::begin(float x, float y, double time, float brushSize) {
+    points[0] = points[1] = points[2] = points[3] = glm::vec2(x, y);
+    times[0] = times[1] = times[2] = times[3] = time;
+    pointCount = 1;
+    spacing = spacingFor(brushSize);
+    carried = 0.0f;
+}
+
+void StrokeSampler::addPoint(float x, float y, double time, std::vector<StrokeSample>& samples) {
+    glm::vec2 point(x, y);
+
+    // Jitter well below the spacing only adds kinks to the spline
+    if (glm::length(point - points[3]) < spacing * 0.25f) return;
+
+    points[0] = points[1];
+    points[1] = points[2];
+    points[2] = points[3];
+    points[3] = point;
+    times[0] = times[1];
+    times[1] = times[2];
+    times[2] = times[3];
+    times[3] = time;
+    pointCount++;
+
+    // The segment between the two middle points is known once a point past it arrives;
+    // at the start of the stroke the missing neighbour is mirrored by repeating the first point
+    if (pointCount >= 3)
+        emitSegment(points[0], points[1], points[2], points[3], times[1], times[2], samples);
+}
+
+void StrokeSampler::finish(std::vector<StrokeSample>& samples) {
+    if (pointCount >= 2)
+        emitSegment(points[1], points[2], points[3], points[3], times[2], times[3], samples);
+
+    // Always end exactly at the last cursor position
+    if (pointCount >= 2 && (samples.empty() || samples.back().position != points[3]) && carried > spacing * 0.25f)
+        samples.push_back({ points[3], times[3] });
+
+    pointCount = 0;
+}
+
+void StrokeSampler::emitSegment(const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3,
+    double t1, double t2, std::vector<StrokeSample>& samples) {
+    float angle = std::max(turnAngle(p0, p1, p2), turnAngle(p1, p2, p3));
+    float scale = 1.0f;
+    if (angle > CURVATURE_THRESHOLD)
+        scale = std::max(1.0f - (angle - CURVATURE_THRESHOLD) / 3.14159265f, MIN_SPACING_SCALE);
+    float step = spacing * scale;
+
+    glm::vec2 previous = p1;
+    for (int i = 1; i <= STEPS_PER_SEGMENT; i++) {
+        glm::vec2 current = catmullRom(p0, p1, p2, p3, (float)i / STEPS_PER_SEGMENT);
+        float length = glm::length(current - previous);
+        float pieceLength = length;
+
+        // Place samples exactly at multiples of the step along this piece
+        while (carried + length >= step) {
+            float t = (step - carried) / length;
+            glm::vec2 sample = previous + (current - previous) * t;
+            length -= step - carried;
+
+            // Time advances linearly with the spline parameter between the two cursor samples
+            double u = (i - length / pieceLength) / STEPS_PER_SEGMENT;
+            samples.push_back({ sample, t1 + (t2 - t1) * u });
+            previous = sample;
+            carried = 0.0f;
+        }
+
+        carried += length;
+        previous = current;
+    }
+}
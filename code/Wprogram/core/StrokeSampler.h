@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "glm/glm.hpp"
+
+struct StrokeSample {
+    glm::vec2 position;
+    // Input clock time, interpolated between the cursor samples the position came from
+    double time;
+};
+
+// Turns raw cursor positions into evenly spaced circle centers.
+// A Catmull-Rom spline is fitted through the cursor samples and walked by arc length.
+// Spacing is a fraction of the visible brush radius, tightened only where the path turns sharply.
+// Output lags the cursor by one segment, finish() flushes the tail.
+class StrokeSampler {
+private:
+    static constexpr float SPACING_FRACTION = 0.4f;
+    // Turns sharper than this (radians) get denser sampling, down to MIN_SPACING_SCALE
+    static constexpr float CURVATURE_THRESHOLD = 0.5f;
+    static constexpr float MIN_SPACING_SCALE = 0.5f;
+    static constexpr int STEPS_PER_SEGMENT = 16;
+
+    // Last four control points, points[3] is the newest cursor sample
+    glm::vec2 points[4];
+    double times[4];
+    int pointCount;
+    float spacing;
+    // Arc length walked since the last emitted sample
+    float carried;
+
+    void emitSegment(const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3,
+        double t1, double t2, std::vector<StrokeSample>& samples);
+
+public:
+    StrokeSampler();
+
+    // Basic.shader keeps fragments within brushSize of the quad center in texture space and
+    // the quad is 2 * brushSize wide, so a circle's visible radius is 2 * brushSize^2
+    static float visibleRadius(float brushSize) { return 2.0f * brushSize * brushSize; }
+
+    // Distance between samples on straight runs
+    static float spacingFor(float brushSize) { return std::max(visibleRadius(brushSize) * SPACING_FRACTION, 0.001f); }
+
+    // The starting point is the first circle and is not emitted again
+    void begin(float x, float y, double time, float brushSize);
+
+    void addPoint(float x, float y, double time, std::vector<StrokeSample>& samples);
+
+    void finish(std::vector<StrokeSample>& samples);
+};
@@ -0,0 +1,74 @@
+#include "StrokeSimplifier.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+
+    float distanceToSegment(const Circle& p, const Circle& a, const Circle& b) {
+        float abx = b.centerX - a.centerX;
+        float aby = b.centerY - a.centerY;
+        float apx = p.centerX - a.centerX;
+        float apy = p.centerY - a.centerY;
+
+        float lengthSquared = abx * abx + aby * aby;
+        float t = lengthSquared > 0.0f ? (apx * abx + apy * aby) / lengthSquared : 0.0f;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+        float dx = apx - abx * t;
+        float dy = apy - aby * t;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    float distanceBetween(const Circle& a, const Circle& b) {
+        float dx = b.centerX - a.centerX;
+        float dy = b.centerY - a.centerY;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+}
+
+std::vector<Circle> simplifyStroke(const std::vector<Circle>& circles, float tolerance, float maxGap) {
+    if (circles.size() < 3) return circles;
+
+    std::vector<bool> keep(circles.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    // Explicit stack, long strokes would recurse thousands of levels deep
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.push_back({ 0, circles.size() - 1 });
+
+    while (!ranges.empty()) {
+        size_t first = ranges.back().first;
+        size_t last = ranges.back().second;
+        ranges.pop_back();
+        if (last - first < 2) continue;
+
+        size_t farthest = first;
+        float farthestDistance = 0.0f;
+        for (size_t i = first + 1; i < last; i++) {
+            float distance = distanceToSegment(circles[i], circles[first], circles[last]);
+            if (distance > farthestDistance) {
+                farthestDistance = distance;
+                farthest = i;
+            }
+        }
+
+        // Also split spans that are too long to leave as a single gap, at their midpoint
+        if (farthestDistance <= tolerance) {
+            if (distanceBetween(circles[first], circles[last]) <= maxGap) continue;
+            farthest = (first + last) / 2;
+        }
+
+        keep[farthest] = true;
+        ranges.push_back({ first, farthest });
+        ranges.push_back({ farthest, last });
+    }
+
+    std::vector<Circle> simplified;
+    for (size_t i = 0; i < circles.size(); i++) {
+        if (keep[i])
+            simplified.push_back(circles[i]);
+    }
+    return simplified;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <vector>
+#include "Circle.h"
+
+struct SimplificationStats {
+    unsigned long long strokes = 0;
+    unsigned long long pointsIn = 0;
+    unsigned long long pointsOut = 0;
+
+    unsigned long long pointsRemoved() const { return pointsIn - pointsOut; }
+};
+
+// Ramer-Douglas-Peucker on circle centers. Circles within tolerance of the simplified
+// polyline are dropped; maxGap caps the distance between kept circles so hit testing,
+// which works on circles, still covers the whole stroke. The renderer refills the gaps.
+std::vector<Circle> simplifyStroke(const std::vector<Circle>& circles, float tolerance, float maxGap);
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+
+// Lock-free single producer / single consumer handoff.
+// The writer always has a private back slot and the reader a private front slot;
+// the third slot is swapped atomically between them, so neither side ever blocks.
+template<typename T>
+class TripleBuffer {
+private:
+    static constexpr unsigned char INDEX_MASK = 0x3;
+    static constexpr unsigned char FRESH_BIT = 0x4;
+
+    T slots[3];
+    std::atomic<unsigned char> middle;
+    unsigned char back;
+    unsigned char front;
+
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side
+    T& getWriteBuffer() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // True while the last published slot has not been picked up by the reader yet
+    bool hasPending() const {
+        return (middle.load(std::memory_order_acquire) & FRESH_BIT) != 0;
+    }
+
+    // Reader side, returns false when nothing new was published since the last call
+    bool consume() {
+        if (!hasPending()) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    T& getReadBuffer() { return slots[front]; }
+};
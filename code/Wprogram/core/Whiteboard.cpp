@@ -1,30 +1,9 @@
 #include "Whiteboard.h"
+#include <bit>
 
 Whiteboard::Whiteboard(int width, int height) {
 	currentColor.resize(3);
 
-    float positions[] = {
-        // positions      // texture coords
-        -0.5f, -0.5f,     0.0f, 0.0f,  // Bottom-left
-         0.5f, -0.5f,     1.0f, 0.0f,  // Bottom-right
-         0.5f,  0.5f,     1.0f, 1.0f,  // Top-right
-        -0.5f,  0.5f,     0.0f, 1.0f   // Top-left
-    };
-    unsigned int indices[] = {
-           0, 1, 2,
-           2, 3, 0
-    };
-
-    va = new VertexArray();
-    vb = new VertexBuffer(positions, sizeof(positions));
-    ib = new IndexBuffer(indices, 6);
-    VertexBufferLayout layout;
-    layout.Push<float>(2);
-    layout.Push<float>(2);
-    va->AddBuffer(*vb, layout);
-    shader=new Shader(std::string(SHADER_PATH) + "/Basic.shader");
-    renderer = &Renderer::getInstance();
-
     float aspect = (float)width / (float)height;
     proj = glm::ortho(
         -2.0f * aspect, 2.0f * aspect,  // Left, Right
@@ -33,86 +12,156 @@ Whiteboard::Whiteboard(int width, int height) {
     );
     view = glm::mat4(1.0f);
 
-    GLCall(glEnable(GL_BLEND));
-    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-
     currentColor[0] = 0.0f;
     currentColor[1] = 0.0f;
     currentColor[2] = 0.0f;
 
     currentBrushSize = 0.05f;
+    currentBrush = BrushType::Round;
 
     currentMode = DrawingMode::DRAW;
+    partialErase = false;
+    simplifyStrokes = true;
+    predictionHorizon = 0.0;
+    eraseSession = 0;
+    lastEraserPosition = glm::vec2(0.0f);
 
     isDrawing = false;
-}
 
-Whiteboard::~Whiteboard() {
-    delete va;
-    delete vb;
-    delete ib;
-    delete shader;
+    nextImageId = 0;
+
+    boardChanged = true;
 }
 
-void Whiteboard::startDrawing(float x, float y) {
+void Whiteboard::startDrawing(float x, float y, double time) {
     isDrawing = true;
 
     tempCircles.clear();
+    strokeInput.clear();
+    predictedCircles.clear();
     erasedStrokeIndices.clear();
+    erasedStrokeFlags.assign(strokes.size(), false);
+    erasedCircles.clear();
+    erasedCircleKeys.clear();
+    eraseSession++;
     if (currentMode == DrawingMode::DRAW) {
         Circle firstCircle(x, y, currentBrushSize);
         tempCircles.push_back(firstCircle);
+
+        // Snapshots of the previous stroke may still be on the render thread, so start a fresh store
+        liveStroke = std::make_shared<LiveStroke>();
+        liveStroke->append(firstCircle);
+        pendingInputTimes.push_back(time);
+
+        strokeInput.push_back({ glm::vec2(x, y), time });
+        sampler.begin(x, y, time, currentBrushSize);
     }
     else
     {
-        for (int i = 0; i < strokes.size(); i++) {
-            if (strokeIntersectsEraser(strokes[i], x, y, currentBrushSize)) {
-                if (std::find(erasedStrokeIndices.begin(),
-                    erasedStrokeIndices.end(), i) == erasedStrokeIndices.end()) {
-                    erasedStrokeIndices.push_back(i);
-                }
-            }
+        liveStroke.reset();
+        lastEraserPosition = glm::vec2(x, y);
+
+        CircleHitTest::Capsule eraser = { x, y, x, y, currentBrushSize };
+        if (partialErase) {
+            collectErasedCircles(eraser);
+            return;
         }
+
+        collectErasedStrokes(eraser);
     }
 }
 
 void Whiteboard::addCircle(float x, float y) {
+    PROFILE_ZONE("Whiteboard::addCircle");
     if (!isDrawing) return;
     if (currentMode == DrawingMode::DRAW) {
         Circle newCircle(x, y, currentBrushSize);
         tempCircles.push_back(newCircle);
+        liveStroke->append(newCircle);
     }
     else
     {
-        for (int i = 0; i < strokes.size(); i++) {
-            if (strokeIntersectsEraser(strokes[i], x, y, currentBrushSize)) {
-                if (std::find(erasedStrokeIndices.begin(),
-                    erasedStrokeIndices.end(), i) == erasedStrokeIndices.end()) {
-                    erasedStrokeIndices.push_back(i);
-                }
-            }
+        // Sweep from the previous position so fast swipes do not jump over strokes between events
+        CircleHitTest::Capsule eraser = { lastEraserPosition.x, lastEraserPosition.y, x, y, currentBrushSize };
+        lastEraserPosition = glm::vec2(x, y);
+
+        if (partialErase) {
+            collectErasedCircles(eraser);
+            return;
         }
+
+        collectErasedStrokes(eraser);
     }
 }
 
+void Whiteboard::addPoint(float x, float y, double time) {
+    PROFILE_ZONE("Whiteboard::addPoint");
+    if (!isDrawing) return;
+    if (currentMode != DrawingMode::DRAW) {
+        addCircle(x, y);
+        return;
+    }
+
+    strokeInput.push_back({ glm::vec2(x, y), time });
+    sampler.addPoint(x, y, time, samples);
+    addSampledCircles();
+}
+
+void Whiteboard::addSampledCircles() {
+    for (const StrokeSample& sample : samples) {
+        Circle circle(sample.position.x, sample.position.y, currentBrushSize);
+        tempCircles.push_back(circle);
+        liveStroke->append(circle);
+        pendingInputTimes.push_back(sample.time);
+    }
+    samples.clear();
+}
+
 Command* Whiteboard::endDrawing() {
     if (!isDrawing) return nullptr; 
 
     isDrawing = false;
+    predictedCircles.clear();
 
     if (currentMode == DrawingMode::DRAW) {
+        sampler.finish(samples);
+        addSampledCircles();
+
         if (tempCircles.empty()) return nullptr;
 
+        if (simplifyStrokes) {
+            std::vector<Circle> simplified = simplifyStroke(tempCircles,
+                StrokeSampler::visibleRadius(currentBrushSize) * SIMPLIFY_TOLERANCE,
+                StrokeSampler::spacingFor(currentBrushSize) * SIMPLIFY_MAX_GAP);
+
+            simplificationStats.strokes++;
+            simplificationStats.pointsIn += tempCircles.size();
+            simplificationStats.pointsOut += simplified.size();
+            tempCircles.swap(simplified);
+        }
 
         DrawCommand* cmd = new DrawCommand(
             tempCircles,
             currentColor,
             currentBrushSize,
+            currentBrush,
             &strokes
         );
 
         return cmd;
     }
+    else if (partialErase)
+    {
+        if (erasedCircles.empty()) {
+            return nullptr;
+        }
+
+        PartialEraseCommand* cmd = new PartialEraseCommand(erasedCircles, &strokes);
+
+        erasedCircles.clear();
+        erasedCircleKeys.clear();
+        return cmd;
+    }
     else
     {
 
@@ -132,80 +181,96 @@ Command* Whiteboard::endDrawing() {
     }
 }
 
-void Whiteboard::render() {
-    renderer->Clear();
-    shader->Bind();
-
-    shader->SetUniform2f("circleCenter", 0.5f, 0.5f);
-
-    glm::mat4 vp = proj * view;
-
-    for (int i = 0; i < strokes.size(); i++) {
-        Stroke& stroke = strokes[i];
-
-        if (stroke.circles.empty()) continue;
-
-        bool beingErased = std::find(erasedStrokeIndices.begin(),
-            erasedStrokeIndices.end(),
-            i) != erasedStrokeIndices.end();
+Command* Whiteboard::importImage(int pixelWidth, int pixelHeight, std::shared_ptr<const unsigned char> pixels, float x, float y) {
+    if (!pixels || pixelWidth <= 0 || pixelHeight <= 0) return nullptr;
 
-        float alpha = beingErased ? 0.3f : 1.0f;
+    float scale = IMPORTED_IMAGE_EXTENT / (float)std::max(pixelWidth, pixelHeight);
 
-        shader->SetUniform4f("u_color",stroke.color[0],stroke.color[1],stroke.color[2],alpha);
+    BoardImage image;
+    image.id = nextImageId++;
+    image.pixelWidth = pixelWidth;
+    image.pixelHeight = pixelHeight;
+    image.pixels = std::move(pixels);
+    image.centerX = x;
+    image.centerY = y;
+    image.width = pixelWidth * scale;
+    image.height = pixelHeight * scale;
 
-        shader->SetUniform1f("circleRadius", stroke.brushSize);
-
-        for (int j = 0; j < stroke.circles.size(); j++) {
-            Circle& circle = stroke.circles[j];
+    return new AddImageCommand(image, &images);
+}
 
-            float diameter = circle.raduis * 2.0f;
+void Whiteboard::predictInk(double now) {
+    predictedCircles.clear();
+    if (!isDrawing || currentMode != DrawingMode::DRAW || tempCircles.empty()) return;
 
-            glm::mat4 model(
-                diameter, 0.0f, 0.0f, 0.0f,
-                0.0f, diameter, 0.0f, 0.0f,
-                0.0f, 0.0f, 1.0f, 0.0f,
-                circle.centerX, circle.centerY, 0.0f, 1.0f
-            );
+    predictedPoints.clear();
+    const Circle& last = tempCircles.back();
+    InkPredictor::predict(strokeInput, glm::vec2(last.centerX, last.centerY), now, predictionHorizon,
+        StrokeSampler::spacingFor(currentBrushSize), predictedPoints);
 
-            glm::mat4 mvp = vp * model;
+    for (const glm::vec2& point : predictedPoints)
+        predictedCircles.emplace_back(point.x, point.y, currentBrushSize);
+}
 
-            shader->SetUniformMat4f("u_MVP", mvp);
-            renderer->Draw(*va, *ib, *shader);
-        }
+void Whiteboard::fillSnapshot(BoardSnapshot& snapshot) {
+    if (boardChanged || !publishedStrokes) {
+        publishedStrokes = std::make_shared<const std::vector<Stroke>>(strokes);
+        // Cheap, image pixels are shared
+        publishedImages = std::make_shared<const std::vector<BoardImage>>(images);
+        boardChanged = false;
     }
 
-    if (isDrawing && !tempCircles.empty()) {
-        shader->SetUniform4f("u_color",
-            currentColor[0],
-            currentColor[1],
-            currentColor[2],
-            1.0f);
+    snapshot.strokes = publishedStrokes;
+    snapshot.images = publishedImages;
+    snapshot.liveStroke = liveStroke;
+    snapshot.liveCircleCount = liveStroke ? liveStroke->size() : 0;
+    snapshot.predictedCircles = predictedCircles;
+    snapshot.inputTimes.swap(pendingInputTimes);
+    pendingInputTimes.clear();
+    snapshot.erasedStrokeIndices = erasedStrokeIndices;
+    snapshot.erasedCircles = erasedCircles;
+    snapshot.eraseSession = eraseSession;
+    snapshot.currentColor = currentColor;
+    snapshot.currentBrushSize = currentBrushSize;
+    snapshot.currentBrush = currentBrush;
+    snapshot.isDrawing = isDrawing;
+    snapshot.proj = proj;
+    snapshot.view = view;
+}
 
-        shader->SetUniform1f("circleRadius", currentBrushSize);
+void Whiteboard::clear() {
+    strokes.clear();
+    images.clear();
+    boardChanged = true;
+}
 
-        for (size_t i = 0; i < tempCircles.size(); i++) {
-            const Circle& circle = tempCircles[i];
+BoardMemoryUsage Whiteboard::getMemoryUsage() const {
+    BoardMemoryUsage usage;
 
-            float diameter = circle.raduis * 2.0f;
+    // Strokes split by a partial erase share one storage, count it once
+    std::unordered_set<const std::vector<Circle>*> seenStorage;
+    usage.strokes = vectorBytes(strokes);
+    for (const Stroke& stroke : strokes) {
+        usage.strokes += stroke.ownBytes();
+        if (seenStorage.insert(stroke.storage.get()).second)
+            usage.strokeStorage += stroke.storageBytes();
+    }
 
-            glm::mat4 model(
-                diameter, 0.0f, 0.0f, 0.0f,
-                0.0f, diameter, 0.0f, 0.0f,
-                0.0f, 0.0f, 1.0f, 0.0f,
-                circle.centerX, circle.centerY, 0.0f, 1.0f
-            );
+    usage.tempCircles = vectorBytes(tempCircles);
+    usage.liveStroke = liveStroke ? liveStroke->memoryUsage() : 0;
+    usage.input = vectorBytes(samples) + vectorBytes(strokeInput) + vectorBytes(pendingInputTimes)
+        + vectorBytes(predictedCircles) + vectorBytes(predictedPoints);
 
-            glm::mat4 mvp = vp * model;
+    // Hash set nodes hold the key and a next pointer, plus one pointer per bucket
+    usage.eraser = vectorBytes(erasedStrokeIndices) + erasedStrokeFlags.capacity() / 8 + vectorBytes(erasedCircles)
+        + vectorBytes(eraserHitMask) + erasedCircleKeys.size() * (sizeof(unsigned long long) + sizeof(void*))
+        + erasedCircleKeys.bucket_count() * sizeof(void*);
 
-            shader->SetUniformMat4f("u_MVP", mvp);
-            renderer->Draw(*va, *ib, *shader);
-        }
-    }
-    
-}
+    usage.images = vectorBytes(images);
+    for (const BoardImage& image : images)
+        usage.images += (size_t)image.pixelWidth * image.pixelHeight * 4;
 
-void Whiteboard::clear() {
-    strokes.clear();
+    return usage;
 }
 
 void Whiteboard::setColor(float r, float g, float b) {
@@ -234,102 +299,61 @@ void Whiteboard::setDrawingMode(DrawingMode mode) {
 bool Whiteboard::circleIntersectsEraser(const Circle& circle, float eraserX, float eraserY, float eraserRad) {
     float dx = circle.centerX - eraserX;
     float dy = circle.centerY - eraserY;
-    float distance = sqrt(dx * dx + dy * dy);
+    float reach = circle.raduis + eraserRad;
 
-    return distance < (circle.raduis + eraserRad);
+    return dx * dx + dy * dy < reach * reach;
 }
 
 bool Whiteboard::strokeIntersectsEraser(const Stroke& stroke, float eraserX, float eraserY, float eraserRad) {
-    for (const auto& circle : stroke.circles) {
-        if (circleIntersectsEraser(circle, eraserX, eraserY, eraserRad)) {
-            return true;
-        }
-    }
-    return false;
+    return CircleHitTest::firstHit(*stroke.arrays, stroke.offset, stroke.count, eraserX, eraserY, eraserRad) >= 0;
 }
 
-bool Whiteboard::saveDrawing(const std::string& filename,int sidebarWidth,int windowWidth,int windowHeight) {
-    int drawingWidth = windowWidth - sidebarWidth;
-    int drawingHeight = windowHeight;
 
-    unsigned char* pixels = new unsigned char[drawingWidth * drawingHeight * 4];
+void Whiteboard::collectErasedStrokes(const CircleHitTest::Capsule& eraser) {
+    PROFILE_ZONE("Whiteboard::collectErasedStrokes");
+    float left = std::min(eraser.x0, eraser.x1) - eraser.radius;
+    float right = std::max(eraser.x0, eraser.x1) + eraser.radius;
+    float bottom = std::min(eraser.y0, eraser.y1) - eraser.radius;
+    float top = std::max(eraser.y0, eraser.y1) + eraser.radius;
 
-    glReadPixels(
-        sidebarWidth,      // x: skip sidebar
-        0,                 // y: from bottom
-        drawingWidth,      // width: drawing area only
-        drawingHeight,     // height: full height
-        GL_RGBA,           // format: Red, Green, Blue, Alpha
-        GL_UNSIGNED_BYTE,  // type: 8-bit unsigned byte per channel
-        pixels             // destination buffer
-    );
+    // The flags are indexed like strokes and must cover every one of them
+    erasedStrokeFlags.resize(strokes.size(), false);
 
-    // Flip image vertically (OpenGL is bottom-to-top, images are top-to-bottom)
-    unsigned char* flippedPixels = new unsigned char[drawingWidth * drawingHeight * 4];
-    for (int y = 0; y < drawingHeight; y++) {
-        memcpy(
-            flippedPixels + (drawingHeight - 1 - y) * drawingWidth * 4,
-            pixels + y * drawingWidth * 4,
-            drawingWidth * 4
-        );
-    }
+    for (size_t i = 0; i < strokes.size(); i++) {
+        // Strokes already marked this gesture are neither tested nor added again
+        if (erasedStrokeFlags[i]) continue;
+
+        const Stroke& stroke = strokes[i];
+        if (!stroke.boundsOverlap(left, bottom, right, top)) continue;
 
-    // Get file extension
-    std::string ext = "";
-    size_t dotPos = filename.find_last_of(".");
-    if (dotPos != std::string::npos) {
-        ext = filename.substr(dotPos + 1);
-        // Convert to lowercase
-        for (char& c : ext) {
-            c = tolower(c);
+        if (CircleHitTest::firstHit(*stroke.arrays, stroke.offset, stroke.count, eraser) >= 0) {
+            erasedStrokeFlags[i] = true;
+            erasedStrokeIndices.push_back((int)i);
         }
     }
+}
 
-    int result = 0;
-
-    if (ext == "png") {
-        result = stbi_write_png(
-            filename.c_str(),        // filename
-            drawingWidth,            // width
-            drawingHeight,           // height
-            4,                       // channels (RGBA)
-            flippedPixels,          // pixel data
-            drawingWidth * 4        // stride (bytes per row)
-        );
-    }
-    else if (ext == "jpg" || ext == "jpeg") {
-        result = stbi_write_jpg(
-            filename.c_str(),        // filename
-            drawingWidth,            // width
-            drawingHeight,           // height
-            4,                       // channels (RGBA)
-            flippedPixels,          // pixel data
-            95                      // quality (1-100, 95 is high quality)
-        );
-    }
-    else if (ext == "bmp") {
-        result = stbi_write_bmp(
-            filename.c_str(),        // filename
-            drawingWidth,            // width
-            drawingHeight,           // height
-            4,                       // channels (RGBA)
-            flippedPixels           // pixel data
-        );
-    }
-    else {
-        std::string pngFilename = filename + ".png";
-        result = stbi_write_png(
-            pngFilename.c_str(),
-            drawingWidth,
-            drawingHeight,
-            4,
-            flippedPixels,
-            drawingWidth * 4
-        );
+void Whiteboard::collectErasedCircles(const CircleHitTest::Capsule& eraser) {
+    PROFILE_ZONE("Whiteboard::collectErasedCircles");
+    float left = std::min(eraser.x0, eraser.x1) - eraser.radius;
+    float right = std::max(eraser.x0, eraser.x1) + eraser.radius;
+    float bottom = std::min(eraser.y0, eraser.y1) - eraser.radius;
+    float top = std::max(eraser.y0, eraser.y1) + eraser.radius;
+
+    for (size_t i = 0; i < strokes.size(); i++) {
+        const Stroke& stroke = strokes[i];
+        if (!stroke.boundsOverlap(left, bottom, right, top)) continue;
+
+        if (CircleHitTest::hitMask(*stroke.arrays, stroke.offset, stroke.count, eraser, eraserHitMask) == 0)
+            continue;
+
+        for (size_t word = 0; word < eraserHitMask.size(); word++) {
+            for (uint64_t bits = eraserHitMask[word]; bits != 0; bits &= bits - 1) {
+                unsigned int c = (unsigned int)(word * 64 + std::countr_zero(bits));
+                unsigned long long key = ((unsigned long long)i << 32) | c;
+                if (erasedCircleKeys.insert(key).second)
+                    erasedCircles.push_back({ (int)i, c });
+            }
+        }
     }
-
-    delete[] pixels;
-    delete[] flippedPixels;
-
-    return result != 0;
-}
\ No newline at end of file
+}
@@ -3,38 +3,89 @@
 #include <algorithm>
 #include "Stroke.h"
 #include "Circle.h"
+#include <memory>
+#include <unordered_set>
 #include "DrawCommand.h"
 #include "EraseCommand.h"
-#include "VertexArray.h"
-#include "VertexBuffer.h"
-#include "VertexBufferLayout.h"
-#include "IndexBuffer.h"
-#include "Shader.h"
-#include "Renderer.h"
+#include "PartialEraseCommand.h"
+#include "AddImageCommand.h"
+#include "BoardImage.h"
+#include "BoardSnapshot.h"
+#include "MemoryUsage.h"
+#include "StrokeSampler.h"
+#include "StrokeSimplifier.h"
+#include "InkPredictor.h"
+#include "Profiler.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
-#include <stb_image_write.h>
 
 class Whiteboard {
 private:
     std::vector<Stroke> strokes;
 
-    VertexArray* va;
-    VertexBuffer* vb;
-    IndexBuffer* ib;
-    Shader* shader;
-    Renderer* renderer;
+    // Drawn behind every stroke, in insertion order
+    std::vector<BoardImage> images;
+    int nextImageId;
+
+    std::shared_ptr<const std::vector<Stroke>> publishedStrokes;
+    std::shared_ptr<const std::vector<BoardImage>> publishedImages;
+    bool boardChanged;
 
     glm::mat4 proj;
     glm::mat4 view;
 
     std::vector<float> currentColor;
     float currentBrushSize;
+    BrushType currentBrush;
     bool isDrawing;
     std::vector<Circle> tempCircles;
+    std::shared_ptr<LiveStroke> liveStroke;
+
+    StrokeSampler sampler;
+    std::vector<StrokeSample> samples;
+
+    // Raw timestamped cursor positions of the stroke being drawn, for velocity-based features
+    std::vector<StrokeSample> strokeInput;
+
+    // Input timestamps of the circles added since the last snapshot, for latency measurement
+    std::vector<double> pendingInputTimes;
 
+    // Provisional tail drawn past the live stroke, rebuilt every frame and never committed
+    double predictionHorizon;
+    std::vector<Circle> predictedCircles;
+    std::vector<glm::vec2> predictedPoints;
+
+    void addSampledCircles();
+
+    // Finished strokes are simplified before they are committed; the renderer fills the gaps back in
+    bool simplifyStrokes;
+    SimplificationStats simplificationStats;
+
+    // Whole-stroke erase: strokes hit so far in hit order, plus a flag per stroke for O(1) membership
     std::vector<int> erasedStrokeIndices;
+    std::vector<bool> erasedStrokeFlags;
+    unsigned long long eraseSession;
+
+    // Partial erase: circles under the eraser so far as (stroke index, circle index), in hit order
+    bool partialErase;
+    std::vector<std::pair<int, unsigned int>> erasedCircles;
+    std::unordered_set<unsigned long long> erasedCircleKeys;
+    // Per-stroke hit bits, reused between eraser positions
+    std::vector<uint64_t> eraserHitMask;
+
+    // Where the eraser was at the previous cursor event; each query covers the path from there
+    glm::vec2 lastEraserPosition;
+
+    void collectErasedStrokes(const CircleHitTest::Capsule& eraser);
+
+    void collectErasedCircles(const CircleHitTest::Capsule& eraser);
 public:
+    static constexpr float IMPORTED_IMAGE_EXTENT = 3.0f;
+    // Simplification tolerance as a fraction of the visible brush radius
+    static constexpr float SIMPLIFY_TOLERANCE = 0.1f;
+    // Longest gap left between kept circles, in sampler spacings
+    static constexpr float SIMPLIFY_MAX_GAP = 4.0f;
+
     enum class DrawingMode {
         DRAW,
         ERASE
@@ -43,16 +94,26 @@ public:
     DrawingMode currentMode;
 
     Whiteboard(int width, int height);
-        
-    ~Whiteboard();
 
-    void startDrawing(float x, float y);
+    // time is on the PointerInput clock
+    void startDrawing(float x, float y, double time = 0.0);
 
     void addCircle(float x, float y);
 
+    // Feeds a cursor position through the adaptive sampler while drawing; erasing uses it as is
+    void addPoint(float x, float y, double time = 0.0);
+
     Command* endDrawing();
 
-    void render();
+    // Re-extrapolates the predicted tail from the input received so far, now is on the PointerInput clock
+    void predictInk(double now);
+
+    // Places a decoded image centered on x, y, scaled to fit IMPORTED_IMAGE_EXTENT world units
+    Command* importImage(int pixelWidth, int pixelHeight, std::shared_ptr<const unsigned char> pixels, float x, float y);
+
+    void fillSnapshot(BoardSnapshot& snapshot);
+
+    void markBoardChanged() {boardChanged = true;}
 
     void clear();
 
@@ -62,21 +123,46 @@ public:
 
     float getBrushSize() {return currentBrushSize;}
 
+    void setBrush(BrushType brush) {currentBrush = brush;}
+
+    BrushType getBrush() {return currentBrush;}
+
     std::vector<Stroke>& getStrokes() {return strokes;}
 
+    std::vector<BoardImage>& getImages() {return images;}
+
     bool getIsDrawing() {return isDrawing;}
 
+    const std::vector<StrokeSample>& getStrokeInput() {return strokeInput;}
+
     void updateProjection(int width, int height);
 
     void setDrawingMode(DrawingMode mode);
 
     DrawingMode getDrawingMode() {return currentMode;}
 
+    // When set, the eraser removes only the circles it touches and splits the strokes around them
+    void setPartialErase(bool partial) {partialErase = partial;}
+
+    bool getPartialErase() {return partialErase;}
+
+    void setSimplifyStrokes(bool simplify) {simplifyStrokes = simplify;}
+
+    bool getSimplifyStrokes() {return simplifyStrokes;}
+
+    const SimplificationStats& getSimplificationStats() {return simplificationStats;}
+
+    // Seconds of predicted ink past the latest cursor sample, 0 turns prediction off
+    void setPredictionHorizon(double horizon) {predictionHorizon = horizon;}
+
+    double getPredictionHorizon() {return predictionHorizon;}
+
+    // Walks the whole board, call it on demand rather than every frame
+    BoardMemoryUsage getMemoryUsage() const;
+
     bool circleIntersectsEraser(const Circle& circle, float eraserX, float eraserY, float eraserRad);
 
     bool strokeIntersectsEraser(const Stroke& stroke, float eraserX, float eraserY, float eraserRad);
 
     std::vector<int>& getErasedStrokeIndices() {return erasedStrokeIndices;}
-
-    bool saveDrawing(const std::string& filename, int sidebarWidth, int windowWidth, int windowHeight);
 };
\ No newline at end of file
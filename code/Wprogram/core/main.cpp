@@ -1,12 +1,17 @@
 ﻿#include <glad/glad.h>
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
-#include "imgui_impl_opengl3.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <stack>
 #include <fstream>
 #include <string>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
 
 #include "Renderer.h"
 #include "VertexBuffer.h"
@@ -15,6 +20,7 @@
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "GpuMemory.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -30,18 +36,59 @@
 #include "Whiteboard.h"
 #include "Command.h"
 #include "DrawCommand.h"
+#include "RenderThread.h"
+#include "ImageImporter.h"
+#include "PointerInput.h"
+#include "Profiler.h"
+#include "InputRecording.h"
 
 Whiteboard* g_whiteboard = nullptr;
 std::stack<Command*>* g_undoStack = nullptr;
 std::stack<Command*>* g_redoStack = nullptr;
-double g_lastMouseX = 0.0;
-double g_lastMouseY = 0.0;
+ImageImporter* g_imageImporter = nullptr;
+PointerInput* g_pointerInput = nullptr;
+InputRecorder* g_recorder = nullptr;
 const float SIDEBAR_WIDTH = 300.0f;
 
 Whiteboard::DrawingMode g_currentMode = Whiteboard::DrawingMode::DRAW;
 
 void SetupModernStyle();
 
+// ImGui allocates through these so the sidebar can show what the UI holds.
+// Each block keeps its size in a header padded to preserve the payload's alignment.
+std::atomic<size_t> g_imguiBytes{ 0 };
+constexpr size_t IMGUI_ALLOC_HEADER = alignof(std::max_align_t);
+
+void* imguiAlloc(size_t size, void*) {
+    void* block = malloc(size + IMGUI_ALLOC_HEADER);
+    if (!block) return nullptr;
+
+    *static_cast<size_t*>(block) = size;
+    g_imguiBytes.fetch_add(size, std::memory_order_relaxed);
+    return static_cast<char*>(block) + IMGUI_ALLOC_HEADER;
+}
+
+void imguiFree(void* pointer, void*) {
+    if (!pointer) return;
+
+    void* block = static_cast<char*>(pointer) - IMGUI_ALLOC_HEADER;
+    g_imguiBytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+    free(block);
+}
+
+std::string formatBytes(double bytes) {
+    const char* units[] = { "B", "KB", "MB", "GB" };
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 3) {
+        bytes /= 1024.0;
+        unit++;
+    }
+
+    char text[32];
+    snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s", bytes, units[unit]);
+    return text;
+}
+
 #ifdef _WIN32
 std::string openSaveFileDialog() {
     char filename[MAX_PATH] = "whiteboard.png";
@@ -67,6 +114,28 @@ std::string openSaveFileDialog() {
 
     return "";
 }
+
+std::string openImageFileDialog() {
+    char filename[MAX_PATH] = "";
+
+    OPENFILENAMEA ofn;
+    ZeroMemory(&ofn, sizeof(ofn));
+
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = NULL;
+    ofn.lpstrFilter = "Images (*.png;*.jpg;*.jpeg;*.bmp;*.tga;*.gif)\0*.png;*.jpg;*.jpeg;*.bmp;*.tga;*.gif\0"
+        "All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = filename;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
+    ofn.lpstrTitle = "Import Image";
+
+    if (GetOpenFileNameA(&ofn)) {
+        return std::string(filename);
+    }
+
+    return "";
+}
 #endif
 
 glm::vec2 screenToWorld(double screenX, double screenY,
@@ -90,91 +159,186 @@ glm::vec2 screenToWorld(double screenX, double screenY,
 }
 
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-    if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        if (action == GLFW_PRESS) {
-            double xpos, ypos;
-            glfwGetCursorPos(window, &xpos, &ypos);
-
-            if (xpos >= SIDEBAR_WIDTH) {
-                int width, height;
-                glfwGetFramebufferSize(window, &width, &height);
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
 
-                glm::vec2 worldPos = screenToWorld(xpos, ypos, width, height);
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
 
-                g_whiteboard->startDrawing(worldPos.x, worldPos.y);
+    // Handled in processPointerInput, in order with the moves around it
+    if (action == GLFW_PRESS)
+        g_pointerInput->press(xpos, ypos);
+    else if (action == GLFW_RELEASE)
+        g_pointerInput->release(xpos, ypos);
+}
 
-                g_lastMouseX = worldPos.x;
-                g_lastMouseY = worldPos.y;
-            }
-        }
-        else if (action == GLFW_RELEASE) {
-            if (g_whiteboard->getIsDrawing()) {
-                Command* cmd = g_whiteboard->endDrawing();
+void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
+    g_pointerInput->move(xpos, ypos);
+}
 
-                if (cmd != nullptr) {
-                    cmd->execute();
+void pushCommand(Command* cmd) {
+    {
+        PROFILE_ZONE("Command::execute");
+        cmd->execute();
+    }
+    g_whiteboard->markBoardChanged();
 
-                    g_undoStack->push(cmd);
+    g_undoStack->push(cmd);
 
-                    while (!g_redoStack->empty()) {
-                        delete g_redoStack->top();
-                        g_redoStack->pop();
-                    }
-                }
-            }
-        }
+    while (!g_redoStack->empty()) {
+        delete g_redoStack->top();
+        g_redoStack->pop();
     }
 }
 
-void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS &&
-        g_whiteboard->getIsDrawing()) {
+void recordAction(InputAction::Type type, float a = 0.0f, float b = 0.0f, float c = 0.0f) {
+    if (g_recorder)
+        g_recorder->record(type, PointerInput::now(), a, b, c);
+}
+
+void undoCommand() {
+    recordAction(InputAction::Type::Undo);
+    // The eraser holds stroke indices until the gesture ends, so the board must not shift under it
+    if (g_whiteboard->getIsDrawing()) return;
+    if (g_undoStack->empty()) return;
 
-        if (xpos >= SIDEBAR_WIDTH) {
-            int width, height;
-            glfwGetFramebufferSize(window, &width, &height);
+    Command* cmd = g_undoStack->top();
+    g_undoStack->pop();
 
-            glm::vec2 worldPos = screenToWorld(xpos, ypos, width, height);
+    {
+        PROFILE_ZONE("Command::undo");
+        cmd->undo();
+    }
+    g_whiteboard->markBoardChanged();
 
-            if (g_whiteboard->getDrawingMode() == Whiteboard::DrawingMode::DRAW) {
-                float dx = worldPos.x - g_lastMouseX;
-                float dy = worldPos.y - g_lastMouseY;
-                float distance = sqrt(dx * dx + dy * dy);
+    g_redoStack->push(cmd);
+}
 
-                if (distance > 0.01f) {
-                    g_whiteboard->addCircle(worldPos.x, worldPos.y);
+void redoCommand() {
+    recordAction(InputAction::Type::Redo);
+    if (g_whiteboard->getIsDrawing()) return;
+    if (g_redoStack->empty()) return;
 
-                    if (distance > 0.05) {
-                        int numSteps = (int)(distance / 0.05) + 1;
+    Command* cmd = g_redoStack->top();
+    g_redoStack->pop();
 
-                        for (int i = 1; i <= numSteps; i++) {
-                            float t = (float)i / (float)numSteps;
+    {
+        PROFILE_ZONE("Command::execute");
+        cmd->execute();
+    }
+    g_whiteboard->markBoardChanged();
 
-                            float interpX = g_lastMouseX + dx * t;
-                            float interpY = g_lastMouseY + dy * t;
+    g_undoStack->push(cmd);
+}
 
-                            g_whiteboard->addCircle(interpX, interpY);
-                        }
-                    }
+void clearBoard() {
+    recordAction(InputAction::Type::Clear);
+    if (g_whiteboard->getIsDrawing()) return;
+    g_whiteboard->clear();
 
-                    g_lastMouseX = worldPos.x;
-                    g_lastMouseY = worldPos.y;
-                }
-            }
-            else
-            {
-                g_whiteboard->addCircle(worldPos.x, worldPos.y);
+    while (!g_undoStack->empty()) {
+        delete g_undoStack->top();
+        g_undoStack->pop();
+    }
+    while (!g_redoStack->empty()) {
+        delete g_redoStack->top();
+        g_redoStack->pop();
+    }
+}
+
+// Taken by value, a std::stack cannot be walked in place and copying the pointers is cheap
+size_t historyMemoryUsage(std::stack<Command*> history) {
+    size_t bytes = 0;
+    for (; !history.empty(); history.pop())
+        bytes += history.top()->getMemoryUsage();
+    return bytes;
+}
+
+void setDrawingMode(Whiteboard::DrawingMode mode) {
+    recordAction(InputAction::Type::Mode, (float)mode);
+    g_whiteboard->setDrawingMode(mode);
+    g_currentMode = mode;
+}
 
-                g_lastMouseX = worldPos.x;
-                g_lastMouseY = worldPos.y;
+// Applies a batch of pointer events in order.
+// The screen to world mapping is worked out once for the whole batch.
+void processPointerInput(const std::vector<PointerEvent>& events, int width, int height) {
+    PROFILE_ZONE("processPointerInput");
+    if (events.empty()) return;
+
+    float adjustedWidth = width - SIDEBAR_WIDTH;
+    float aspect = adjustedWidth / (float)height;
+    float scaleX = 4.0f * aspect / adjustedWidth;
+    float scaleY = 4.0f / height;
+
+    for (const PointerEvent& event : events) {
+        if (g_recorder)
+            g_recorder->record((InputAction::Type)event.type, event.time, (float)event.x, (float)event.y);
+
+        bool onBoard = event.x >= SIDEBAR_WIDTH;
+        float worldX = (float)(event.x - SIDEBAR_WIDTH) * scaleX - 2.0f * aspect;
+        float worldY = 2.0f - (float)event.y * scaleY;
+
+        switch (event.type) {
+        case PointerEvent::Type::Press:
+            if (onBoard)
+                g_whiteboard->startDrawing(worldX, worldY, event.time);
+            break;
+        case PointerEvent::Type::Move:
+            // Spacing and interpolation are handled by the whiteboard's stroke sampler
+            if (onBoard && g_whiteboard->getIsDrawing())
+                g_whiteboard->addPoint(worldX, worldY, event.time);
+            break;
+        case PointerEvent::Type::Release:
+            if (g_whiteboard->getIsDrawing()) {
+                Command* cmd = g_whiteboard->endDrawing();
+                if (cmd != nullptr)
+                    pushCommand(cmd);
             }
+            break;
         }
     }
 }
 
+void dropCallback(GLFWwindow* window, int count, const char** paths) {
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+
+    // Images dropped on the sidebar land in the middle of the board
+    glm::vec2 worldPos(0.0f, 0.0f);
+    if (xpos >= SIDEBAR_WIDTH) {
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        worldPos = screenToWorld(xpos, ypos, width, height);
+    }
+
+    // Decoding happens on the importer's worker thread, the command is created once it finishes
+    for (int i = 0; i < count; i++)
+        g_imageImporter->request(paths[i], worldPos.x, worldPos.y);
+}
+
 
-int main()
+int main(int argc, char** argv)
 {
+    // --record FILE captures the session, --replay FILE plays one back (--fast: one recorded frame per frame)
+    std::string recordPath;
+    std::string replayPath;
+    bool replayFast = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc) replayPath = argv[++i];
+        else if (arg == "--fast") replayFast = true;
+        else {
+            std::cerr << "Usage: Wprogram [--record FILE | --replay FILE [--fast]]" << std::endl;
+            return 1;
+        }
+    }
+    // Recording a replay would capture the replayed input again, and --fast only applies to a replay
+    if ((!recordPath.empty() && !replayPath.empty()) || (replayFast && replayPath.empty())) {
+        std::cerr << "Usage: Wprogram [--record FILE | --replay FILE [--fast]]" << std::endl;
+        return 1;
+    }
+
 	 GLFWwindow* window;
     /* Initialize the library */
     if (!glfwInit())
@@ -184,6 +348,9 @@ int main()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+#ifdef WHITEBOARD_GL_DEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
     /* Create a windowed mode window and its OpenGL context */
     window = glfwCreateWindow(1280 , 600, "Hello World", NULL, NULL);
     if (!window)
@@ -193,10 +360,7 @@ int main()
     }
 
 
-    /* Make the window's context current */
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
-    gladLoadGL();
+    /* The render thread makes the context current, loads GL and owns it from then on */
 
     {//to fix the program terminate
         /*float positoins[] = {
@@ -248,15 +412,48 @@ int main()
         std::stack<Command*> redoStack;
 
 
+        Profiler::setThreadName("Main");
+
         g_whiteboard = &whiteboard;
         g_undoStack = &undoStack;
         g_redoStack = &redoStack;
 
+        ImageImporter imageImporter;
+        g_imageImporter = &imageImporter;
+
+        // The event queue stores its slots inline and is far too large for the stack
+        auto pointerInput = std::make_unique<PointerInput>();
+        g_pointerInput = pointerInput.get();
+        std::vector<PointerEvent> pointerEvents;
+
+        std::unique_ptr<InputRecorder> recorder;
+        if (!recordPath.empty()) {
+            recorder = std::make_unique<InputRecorder>(PointerInput::now(), width, height);
+            g_recorder = recorder.get();
+        }
+
+        // While replaying, live input is dropped: pointer events are drained unused, and shortcuts,
+        // board-changing sidebar widgets and image imports are disabled
+        std::unique_ptr<InputReplay> replay;
+        std::vector<InputAction> replayActions;
+        bool replayReported = false;
+        if (!replayPath.empty()) {
+            replay = std::make_unique<InputReplay>();
+            if (!replay->load(replayPath)) {
+                std::cerr << "Failed to load input recording " << replayPath << std::endl;
+                glfwTerminate();
+                return -1;
+            }
+        }
+
 
         glfwSetMouseButtonCallback(window, mouseButtonCallback);
         glfwSetCursorPosCallback(window, cursorPosCallback);
+        glfwSetDropCallback(window, dropCallback);
 
         IMGUI_CHECKVERSION();
+        // Must be in place before the context, which is itself allocated through them
+        ImGui::SetAllocatorFunctions(imguiAlloc, imguiFree);
         ImGui::CreateContext();
         ImGuiIO& io = ImGui::GetIO();
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable; 
@@ -265,63 +462,169 @@ int main()
         SetupModernStyle();
 
         ImGui_ImplGlfw_InitForOpenGL(window, true);
-        ImGui_ImplOpenGL3_Init("#version 330");
+
+        RenderThread renderThread(window);
+        if (!renderThread.start()) {
+            ImGui_ImplGlfw_Shutdown();
+            ImGui::DestroyContext();
+            glfwTerminate();
+            return -1;
+        }
 
         float brushColor[3] = { 0.2f, 0.3f, 0.4f };
         float brushSize = 0.3f;
+        BrushType brushType = BrushType::Round;
+        bool partialErase = false;
+        bool simplifyStrokes = true;
+        bool profileCpu = false;
+        bool predictInk = false;
+        float predictionMs = 25.0f;
+
+        // Last tool values written to the recording, NaN so the first frame records them all
+        float recordedColor[3] = { NAN, NAN, NAN };
+        float recordedBrushSize = NAN;
+        BrushType recordedBrush = (BrushType)-1;
+
+        if (replay)
+            replay->start(!replayFast, PointerInput::now());
 
         while (!glfwWindowShouldClose(window))
         {
             glfwPollEvents();
 
+            // Keep processing input at full event rate until the render thread wants a new frame
+            if (!renderThread.readyForFrame()) {
+                glfwWaitEventsTimeout(0.001);
+                continue;
+            }
+
             int display_w, display_h;
             glfwGetFramebufferSize(window, &display_w, &display_h);
 
-            // Undo (Ctrl+Z)
-            if (ImGui::IsKeyPressed(ImGuiKey_Z) &&
-                (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) ||
-                    ImGui::IsKeyDown(ImGuiKey_RightCtrl))) {
+            pointerEvents.clear();
+            pointerInput->drain(pointerEvents);
 
-                if (!undoStack.empty()) {
-                    Command* cmd = undoStack.top();
-                    undoStack.pop();
+            if (replay) {
+                pointerEvents.clear();
+                replayActions.clear();
+                replay->nextFrame(PointerInput::now(), replayActions);
 
-                    cmd->undo();
+                // Positions were recorded against the recording's framebuffer, map them with it
+                int replayWidth = replay->getFramebufferWidth();
+                int replayHeight = replay->getFramebufferHeight();
 
-                    redoStack.push(cmd);
+                for (const InputAction& action : replayActions) {
+                    if (action.type <= InputAction::Type::Release) {
+                        pointerEvents.push_back({ (PointerEvent::Type)action.type, action.values[0], action.values[1], replay->toClock(action.time) });
+                        continue;
+                    }
+
+                    // UI actions happened after the pointer events before them
+                    processPointerInput(pointerEvents, replayWidth, replayHeight);
+                    pointerEvents.clear();
+
+                    switch (action.type) {
+                    case InputAction::Type::Mode: setDrawingMode((Whiteboard::DrawingMode)(int)action.values[0]); break;
+                    case InputAction::Type::Color: std::copy(action.values, action.values + 3, brushColor); break;
+                    case InputAction::Type::BrushSize: brushSize = action.values[0]; break;
+                    case InputAction::Type::Brush: brushType = (BrushType)(int)action.values[0]; break;
+                    case InputAction::Type::PartialErase:
+                        partialErase = action.values[0] != 0.0f;
+                        whiteboard.setPartialErase(partialErase);
+                        break;
+                    case InputAction::Type::SimplifyStrokes:
+                        simplifyStrokes = action.values[0] != 0.0f;
+                        whiteboard.setSimplifyStrokes(simplifyStrokes);
+                        break;
+                    case InputAction::Type::Undo: undoCommand(); break;
+                    case InputAction::Type::Redo: redoCommand(); break;
+                    case InputAction::Type::Clear: clearBoard(); break;
+                    default: break;
+                    }
+                    whiteboard.setColor(brushColor[0], brushColor[1], brushColor[2]);
+                    whiteboard.setBrushSize(brushSize);
+                    whiteboard.setBrush(brushType);
                 }
+                processPointerInput(pointerEvents, replayWidth, replayHeight);
+
+                if (replay->finished() && !replayReported) {
+                    InputReplay::FrameTimes times = replay->summarizeFrameTimes();
+                    std::cout << "Replay finished: " << times.frames << " frames, frame time ms mean " << times.mean
+                        << " p50 " << times.p50 << " p95 " << times.p95 << " p99 " << times.p99 << " max " << times.max << std::endl;
+                    replayReported = true;
+                }
+            }
+            else {
+                processPointerInput(pointerEvents, display_w, display_h);
+                recordAction(InputAction::Type::Frame);
+            }
+
+            // Undo (Ctrl+Z)
+            if (!replay && ImGui::IsKeyPressed(ImGuiKey_Z) &&
+                (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) ||
+                    ImGui::IsKeyDown(ImGuiKey_RightCtrl))) {
+
+                undoCommand();
             }
 
             // Redo (Ctrl+Y or Ctrl+Shift+Z)
-            if ((ImGui::IsKeyPressed(ImGuiKey_Y) &&
+            if (!replay && ((ImGui::IsKeyPressed(ImGuiKey_Y) &&
                 (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) ||
                     ImGui::IsKeyDown(ImGuiKey_RightCtrl))) ||
                 (ImGui::IsKeyPressed(ImGuiKey_Z) &&
                     (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) ||
                         ImGui::IsKeyDown(ImGuiKey_RightCtrl)) &&
                     (ImGui::IsKeyDown(ImGuiKey_LeftShift) ||
-                        ImGui::IsKeyDown(ImGuiKey_RightShift)))) {
+                        ImGui::IsKeyDown(ImGuiKey_RightShift))))) {
 
-                if (!redoStack.empty()) {
-                    Command* cmd = redoStack.top();
-                    redoStack.pop();
+                redoCommand();
+            }
 
-                    cmd->execute();
+            // Images that finished decoding since the last frame
+            ImageImporter::Result imported;
+            while (imageImporter.poll(imported)) {
+                // Dropped while replaying, the recording does not contain the import
+                if (replay) continue;
 
-                    undoStack.push(cmd);
-                }
-            }
+                Command* cmd = whiteboard.importImage(imported.width, imported.height, imported.pixels, imported.x, imported.y);
 
+                if (cmd == nullptr) {
+                    std::cerr << "Failed to import image " << imported.path << std::endl;
+                    continue;
+                }
 
-            glViewport(SIDEBAR_WIDTH, 0, display_w - SIDEBAR_WIDTH, display_h);
+                pushCommand(cmd);
+            }
 
-            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+            // Sidebar edits show up as changed values, only the changes are recorded
+            if (recorder) {
+                if (!std::equal(brushColor, brushColor + 3, recordedColor)) {
+                    recordAction(InputAction::Type::Color, brushColor[0], brushColor[1], brushColor[2]);
+                    std::copy(brushColor, brushColor + 3, recordedColor);
+                }
+                if (brushSize != recordedBrushSize) {
+                    recordAction(InputAction::Type::BrushSize, brushSize);
+                    recordedBrushSize = brushSize;
+                }
+                if (brushType != recordedBrush) {
+                    recordAction(InputAction::Type::Brush, (float)brushType);
+                    recordedBrush = brushType;
+                }
+            }
 
             g_whiteboard->setColor(brushColor[0], brushColor[1], brushColor[2]);
             g_whiteboard->setBrushSize(brushSize);
-            g_whiteboard->render();
+            g_whiteboard->setBrush(brushType);
+
+            FrameSnapshot& frame = renderThread.beginFrame();
+            frame.framebufferWidth = display_w;
+            frame.framebufferHeight = display_h;
+            frame.sidebarWidth = (int)SIDEBAR_WIDTH;
+            g_whiteboard->predictInk(PointerInput::now());
+            g_whiteboard->fillSnapshot(frame.board);
 
-            ImGui_ImplOpenGL3_NewFrame();
+            // Not a scoped zone, building the UI spans most of the loop body
+            unsigned long long uiStart = Profiler::isEnabled() ? Profiler::now() : 0;
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
 
@@ -336,6 +639,9 @@ int main()
             ImGui::Separator();
             ImGui::Spacing();
 
+            // A replay owns the board, live edits would make it diverge from the recording
+            ImGui::BeginDisabled(replay != nullptr);
+
             ImVec2 btnSize(50, 30);
 
             ImGuiStyle& style = ImGui::GetStyle();
@@ -356,8 +662,7 @@ int main()
             ImGui::PushStyleColor(ImGuiCol_Border, drawBorderColor);
 
             if (ImGui::Button("DRAW", btnSize)) {
-                whiteboard.setDrawingMode(Whiteboard::DrawingMode::DRAW);
-                g_currentMode = Whiteboard::DrawingMode::DRAW;
+                setDrawingMode(Whiteboard::DrawingMode::DRAW);
             }
             ImGui::PopStyleColor(4);
 
@@ -377,13 +682,17 @@ int main()
             ImGui::PushStyleColor(ImGuiCol_Border, eraseBorderColor);
 
             if (ImGui::Button("ERASE", btnSize)) {
-                whiteboard.setDrawingMode(Whiteboard::DrawingMode::ERASE);
-                g_currentMode = Whiteboard::DrawingMode::ERASE;
+                setDrawingMode(Whiteboard::DrawingMode::ERASE);
             }
             ImGui::PopStyleColor(4);
 
             style.FrameBorderSize = oldFrameBorder;
 
+            if (ImGui::Checkbox("Erase partially", &partialErase)) {
+                whiteboard.setPartialErase(partialErase);
+                recordAction(InputAction::Type::PartialErase, partialErase ? 1.0f : 0.0f);
+            }
+
             ImGui::Spacing();
 
             ImGui::Text("Brush Color");
@@ -395,21 +704,136 @@ int main()
 
             ImGui::SliderFloat("Size", &brushSize, 0.15f, 0.5f);
 
-            if (ImGui::Button("Clear")) {
-                whiteboard.clear();
+            if (ImGui::BeginCombo("Brush", getBrushName(brushType))) {
+                for (int i = 0; i < BRUSH_TYPE_COUNT; i++) {
+                    BrushType type = (BrushType)i;
+                    if (ImGui::Selectable(getBrushName(type), type == brushType))
+                        brushType = type;
+                }
+                ImGui::EndCombo();
+            }
+
+            // Changes which circles get stored, so replays need it to reproduce the same strokes
+            if (ImGui::Checkbox("Simplify strokes", &simplifyStrokes)) {
+                whiteboard.setSimplifyStrokes(simplifyStrokes);
+                recordAction(InputAction::Type::SimplifyStrokes, simplifyStrokes ? 1.0f : 0.0f);
+            }
+            ImGui::EndDisabled();
+
+            // The predicted tail only covers the gap to the pen, it is never stored in the stroke
+            bool predictionChanged = ImGui::Checkbox("Predict ink", &predictInk);
+            if (predictInk)
+                predictionChanged |= ImGui::SliderFloat("Horizon (ms)", &predictionMs, 5.0f, 60.0f, "%.0f");
+            if (predictionChanged)
+                whiteboard.setPredictionHorizon(predictInk ? predictionMs / 1000.0 : 0.0);
+
+            const SimplificationStats& simplification = whiteboard.getSimplificationStats();
+            if (simplification.pointsIn > 0)
+                ImGui::Text("Points removed: %llu (%.0f%%)", simplification.pointsRemoved(),
+                    100.0 * simplification.pointsRemoved() / simplification.pointsIn);
+
+            ImGui::BeginDisabled(replay != nullptr);
+            if (ImGui::Button("Clear"))
+                clearBoard();
+            ImGui::EndDisabled();
+
+
+
+            ImGui::Spacing();
+            ImGui::Separator();
+            ImGui::Spacing();
+
+            if (ImGui::CollapsingHeader("Performance")) {
+                RenderStats stats = renderThread.getRenderStats();
+                int newest = (stats.historyOffset + RenderStats::HISTORY - 1) % RenderStats::HISTORY;
+                char overlay[64];
+
+                ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+                ImGui::Text("Draw calls: %llu  Circles: %zu", stats.drawCalls, stats.circles);
+                ImGui::Text("State changes: %llu  Skipped: %llu", stats.stateChangesIssued, stats.stateChangesSkipped);
 
-                while (!undoStack.empty()) {
-                    delete undoStack.top();
-                    undoStack.pop();
+                snprintf(overlay, sizeof(overlay), "CPU %.2f ms", stats.cpuFrameMs[newest]);
+                ImGui::PlotLines("##cpu", stats.cpuFrameMs, RenderStats::HISTORY, stats.historyOffset, overlay, 0.0f, FLT_MAX, ImVec2(-1, 40));
+
+                for (int i = 0; i < stats.passCount; i++) {
+                    snprintf(overlay, sizeof(overlay), "GPU %s %.2f ms", stats.passNames[i], stats.passMs[i][newest]);
+                    ImGui::PushID(i);
+                    ImGui::PlotLines("##pass", stats.passMs[i], RenderStats::HISTORY, stats.historyOffset, overlay, 0.0f, FLT_MAX, ImVec2(-1, 40));
+                    ImGui::PopID();
                 }
-                while (!redoStack.empty()) {
-                    delete redoStack.top();
-                    redoStack.pop();
+
+                // Zones are recorded per thread while enabled, the export covers the last 10 seconds
+                if (ImGui::Checkbox("Record CPU zones", &profileCpu))
+                    Profiler::setEnabled(profileCpu);
+                if (profileCpu && ImGui::Button("Export trace")) {
+                    if (!Profiler::writeChromeTrace("trace.json", 10.0))
+                        std::cerr << "Failed to write trace.json" << std::endl;
                 }
             }
 
+            if (replay) {
+                ImGui::Text("Replay: %s", replay->finished() ? "finished" : "running");
+                InputReplay::FrameTimes times = replay->summarizeFrameTimes();
+                ImGui::Text("Frame p50 %.1f ms  p95 %.1f ms  p99 %.1f ms", times.p50, times.p95, times.p99);
+            }
+            else if (recorder) {
+                ImGui::Text("Recording: %zu actions", recorder->size());
+            }
+
+            if (ImGui::CollapsingHeader("Latency")) {
+                LatencyStats& latency = renderThread.getLatencyStats();
+                LatencyStats::Summary summary = latency.summarize();
+
+                ImGui::Text("Input to display, last %zu samples", summary.count);
+                ImGui::Text("p50 %.1f ms  p95 %.1f ms  p99 %.1f ms", summary.p50, summary.p95, summary.p99);
 
-            //ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+                // Events lost to a full input queue, anything but zero means strokes lost points
+                unsigned long long droppedEvents = pointerInput->getOverflowed();
+                if (droppedEvents > 0)
+                    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Dropped input events: %llu", droppedEvents);
+                else
+                    ImGui::Text("Dropped input events: 0");
+
+                if (ImGui::Button("Export CSV")) {
+                    if (!latency.writeCsv("latency.csv"))
+                        std::cerr << "Failed to write latency.csv" << std::endl;
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Reset"))
+                    latency.clear();
+            }
+
+            if (ImGui::CollapsingHeader("Memory")) {
+                // Walking the board and the history is not free, so it only happens while this is open
+                BoardMemoryUsage board = whiteboard.getMemoryUsage();
+                size_t undoBytes = historyMemoryUsage(undoStack);
+                size_t redoBytes = historyMemoryUsage(redoStack);
+
+                ImGui::Text("Board: %s", formatBytes(board.total()).c_str());
+                ImGui::BulletText("Stroke circles: %s", formatBytes(board.strokeStorage).c_str());
+                ImGui::BulletText("Strokes: %s (%zu)", formatBytes(board.strokes).c_str(), whiteboard.getStrokes().size());
+                ImGui::BulletText("Temp circles: %s", formatBytes(board.tempCircles).c_str());
+                ImGui::BulletText("Live stroke: %s", formatBytes(board.liveStroke).c_str());
+                ImGui::BulletText("Input: %s", formatBytes(board.input).c_str());
+                ImGui::BulletText("Eraser: %s", formatBytes(board.eraser).c_str());
+                ImGui::BulletText("Images: %s", formatBytes(board.images).c_str());
+
+                // Circle storage shared with the board is counted here as well
+                ImGui::Text("Undo: %s (%zu)", formatBytes(undoBytes).c_str(), undoStack.size());
+                ImGui::Text("Redo: %s (%zu)", formatBytes(redoBytes).c_str(), redoStack.size());
+
+                ImGui::Text("GPU buffers: %s", formatBytes(GpuMemory::Get(GpuMemory::Category::Buffers)).c_str());
+                ImGui::Text("GPU textures: %s", formatBytes(GpuMemory::Get(GpuMemory::Category::Textures)).c_str());
+                ImGui::Text("ImGui: %s", formatBytes(g_imguiBytes.load(std::memory_order_relaxed)).c_str());
+
+                // Between frames every command belongs to one of the stacks, anything else has leaked
+                long long liveCommands = Command::getLiveCount();
+                long long heldCommands = (long long)(undoStack.size() + redoStack.size());
+                if (liveCommands != heldCommands)
+                    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Commands alive: %lld, in history: %lld", liveCommands, heldCommands);
+                else
+                    ImGui::Text("Commands alive: %lld", liveCommands);
+            }
 
             ImGui::Spacing();
             ImGui::Separator();
@@ -419,15 +843,16 @@ int main()
             if (ImGui::Button("Save as", ImVec2(-1, 45))) {
                 std::string filename = openSaveFileDialog();
 
-                if (!filename.empty()) {
-                    int display_w, display_h;
-                    glfwGetFramebufferSize(window, &display_w, &display_h);
+                // The render thread reads the board back right after drawing this frame
+                if (!filename.empty())
+                    frame.saveFilename = filename;
+            }
 
-                    bool success = whiteboard.saveDrawing(filename, SIDEBAR_WIDTH, display_w, display_h);
+            if (ImGui::Button("Import image", ImVec2(-1, 45))) {
+                std::string filename = openImageFileDialog();
 
-                    if (!success)
-                        std::cerr << "Failed to save the image" << std::endl;
-                }
+                if (!filename.empty())
+                    imageImporter.request(filename, 0.0f, 0.0f);
             }
 #endif
         
@@ -437,13 +862,20 @@ int main()
             ImGui::End();
 
             ImGui::Render();
+            if (uiStart != 0)
+                Profiler::record("ImGui build", uiStart, Profiler::now());
 
-            glViewport(0, 0, display_w, display_h);
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            frame.captureUi(ImGui::GetDrawData());
+            renderThread.publishFrame();
+        }
+        renderThread.stop();
 
-            /* Swap front and back buffers */
-            glfwSwapBuffers(window);
+        if (recorder) {
+            g_recorder = nullptr;
+            if (!recorder->save(recordPath))
+                std::cerr << "Failed to write input recording " << recordPath << std::endl;
         }
+
         // Cleanup
         while (!undoStack.empty()) {
             delete undoStack.top();
@@ -454,7 +886,6 @@ int main()
             delete redoStack.top();
             redoStack.pop();
         }
-        ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
     
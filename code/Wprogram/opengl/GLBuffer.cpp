@@ -0,0 +1,50 @@
+#include "GLBuffer.h"
+#include "Renderer.h"
+
+unsigned int GetGLBufferUsage(BufferUsage usage)
+{
+    switch (usage)
+    {
+        case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+        case BufferUsage::Stream: return GL_STREAM_DRAW;
+        default: return GL_STATIC_DRAW;
+    }
+}
+
+unsigned int GrowBufferCapacity(unsigned int capacity, unsigned int required)
+{
+    unsigned int newCapacity = capacity > 0 ? capacity : 64;
+    while (newCapacity < required)
+        newCapacity *= 2;
+    return newCapacity;
+}
+
+void ReallocateBuffer(unsigned int buffer, unsigned int usedSize, unsigned int newCapacity, BufferUsage usage)
+{
+    if (usedSize == 0)
+    {
+        BindBufferForWrite(buffer);
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, nullptr, GetGLBufferUsage(usage)));
+        return;
+    }
+
+    // Round trip through a scratch buffer, the copies stay on the GPU
+    unsigned int scratch;
+    GLCall(glGenBuffers(1, &scratch));
+    BindBufferForWrite(scratch);
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, usedSize, nullptr, GL_STREAM_COPY));
+    Renderer::getInstance().BindBuffer(GL_COPY_READ_BUFFER, buffer);
+    GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedSize));
+
+    BindBufferForWrite(buffer);
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, nullptr, GetGLBufferUsage(usage)));
+    Renderer::getInstance().BindBuffer(GL_COPY_READ_BUFFER, scratch);
+    GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedSize));
+
+    GLCall(glDeleteBuffers(1, &scratch));
+}
+
+void BindBufferForWrite(unsigned int buffer)
+{
+    Renderer::getInstance().BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// Shared helpers for VertexBuffer and IndexBuffer.
+
+enum class BufferUsage
+{
+	Static,  // written once, drawn many times
+	Dynamic, // rewritten now and then, drawn many times
+	Stream   // rewritten about as often as it is drawn
+};
+
+unsigned int GetGLBufferUsage(BufferUsage usage);
+
+// Next capacity for a buffer that needs at least required bytes, grows geometrically
+unsigned int GrowBufferCapacity(unsigned int capacity, unsigned int required);
+
+// Reallocates the buffer's storage to newCapacity bytes, keeping the first usedSize bytes.
+// The buffer name does not change, so vertex array attachments stay valid.
+void ReallocateBuffer(unsigned int buffer, unsigned int usedSize, unsigned int newCapacity, BufferUsage usage);
+
+// Binds buffer to GL_COPY_WRITE_BUFFER, which is not part of vertex array state
+void BindBufferForWrite(unsigned int buffer);
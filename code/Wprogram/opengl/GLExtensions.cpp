@@ -0,0 +1,41 @@
+#include "GLExtensions.h"
+
+#include <GLFW/glfw3.h>
+
+static GLExtensions s_Extensions;
+
+static bool HasVersion(int major, int minor)
+{
+	return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+void LoadGLExtensions()
+{
+	s_Extensions = GLExtensions();
+
+	if (HasVersion(4, 1) || glfwExtensionSupported("GL_ARB_get_program_binary"))
+	{
+		s_Extensions.GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC_EXT)glfwGetProcAddress("glGetProgramBinary");
+		s_Extensions.ProgramBinaryLoad = (PFNGLPROGRAMBINARYPROC_EXT)glfwGetProcAddress("glProgramBinary");
+		s_Extensions.ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC_EXT)glfwGetProcAddress("glProgramParameteri");
+
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+		s_Extensions.ProgramBinary = s_Extensions.GetProgramBinary && s_Extensions.ProgramBinaryLoad &&
+			s_Extensions.ProgramParameteri && formats > 0;
+	}
+
+	if (HasVersion(4, 3) || glfwExtensionSupported("GL_KHR_debug"))
+	{
+		s_Extensions.DebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC_EXT)glfwGetProcAddress("glDebugMessageCallback");
+		s_Extensions.DebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC_EXT)glfwGetProcAddress("glDebugMessageControl");
+
+		s_Extensions.DebugOutput = s_Extensions.DebugMessageCallback && s_Extensions.DebugMessageControl;
+	}
+}
+
+const GLExtensions& GetGLExtensions()
+{
+	return s_Extensions;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Entry points newer than the GL 3.3 core profile loaded by glad.
+// They are resolved at runtime and are null when the driver does not provide them.
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#endif
+
+typedef void (APIENTRY* GLDEBUGPROC_EXT)(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC_EXT)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC_EXT)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC_EXT)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC_EXT)(GLDEBUGPROC_EXT callback, const void* userParam);
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECONTROLPROC_EXT)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+
+struct GLExtensions
+{
+	bool ProgramBinary = false;
+	PFNGLGETPROGRAMBINARYPROC_EXT GetProgramBinary = nullptr;
+	PFNGLPROGRAMBINARYPROC_EXT ProgramBinaryLoad = nullptr;
+	PFNGLPROGRAMPARAMETERIPROC_EXT ProgramParameteri = nullptr;
+
+	bool DebugOutput = false;
+	PFNGLDEBUGMESSAGECALLBACKPROC_EXT DebugMessageCallback = nullptr;
+	PFNGLDEBUGMESSAGECONTROLPROC_EXT DebugMessageControl = nullptr;
+};
+
+// Must be called once with a current context, after gladLoadGL()
+void LoadGLExtensions();
+const GLExtensions& GetGLExtensions();
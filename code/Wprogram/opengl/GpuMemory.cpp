@@ -0,0 +1,23 @@
+#include "GpuMemory.h"
+
+#include <atomic>
+
+static std::atomic<long long> s_Bytes[(int)GpuMemory::Category::Count];
+
+void GpuMemory::Add(Category category, long long bytes)
+{
+	s_Bytes[(int)category].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+long long GpuMemory::Get(Category category)
+{
+	return s_Bytes[(int)category].load(std::memory_order_relaxed);
+}
+
+long long GpuMemory::GetTotal()
+{
+	long long total = 0;
+	for (int i = 0; i < (int)Category::Count; i++)
+		total += s_Bytes[i].load(std::memory_order_relaxed);
+	return total;
+}
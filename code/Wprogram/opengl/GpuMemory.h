@@ -0,0 +1,20 @@
+#pragma once
+
+// Bytes of GPU storage the engine's buffer and texture classes have asked the driver for.
+// The driver may pad or place allocations differently, so this is what we are responsible
+// for rather than what the GPU reports. Counters are atomic and can be read from any thread.
+class GpuMemory
+{
+public:
+	enum class Category
+	{
+		Buffers,  // vertex, index, uniform and texture buffers
+		Textures, // texture images including their mip chains
+		Count
+	};
+
+	// bytes may be negative when storage shrinks or is released
+	static void Add(Category category, long long bytes);
+	static long long Get(Category category);
+	static long long GetTotal();
+};
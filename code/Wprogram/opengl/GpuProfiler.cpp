@@ -0,0 +1,103 @@
+#include "GpuProfiler.h"
+#include "Renderer.h"
+
+GpuProfiler::GpuProfiler()
+	: m_Supported(glQueryCounter != nullptr && glGetQueryObjectui64v != nullptr), m_Current(0), m_InPass(false)
+{
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	for (Frame& frame : m_Frames)
+	{
+		for (const Pass& pass : frame.Passes)
+		{
+			m_FreeQueries.push_back(pass.Begin);
+			m_FreeQueries.push_back(pass.End);
+		}
+	}
+	if (!m_FreeQueries.empty())
+	{
+		GLCall(glDeleteQueries((GLsizei)m_FreeQueries.size(), m_FreeQueries.data()));
+	}
+}
+
+GLuint GpuProfiler::AcquireQuery()
+{
+	GLuint query;
+	if (m_FreeQueries.empty())
+	{
+		GLCall(glGenQueries(1, &query));
+		return query;
+	}
+
+	query = m_FreeQueries.back();
+	m_FreeQueries.pop_back();
+	return query;
+}
+
+void GpuProfiler::Resolve(Frame& frame)
+{
+	if (frame.Passes.empty())
+		return;
+
+	// Timestamps complete in order, so the last one being ready means all of them are
+	GLint available = 0;
+	GLCall(glGetQueryObjectiv(frame.Passes.back().End, GL_QUERY_RESULT_AVAILABLE, &available));
+
+	if (available)
+	{
+		m_Results.clear();
+		for (const Pass& pass : frame.Passes)
+		{
+			GLuint64 begin = 0, end = 0;
+			GLCall(glGetQueryObjectui64v(pass.Begin, GL_QUERY_RESULT, &begin));
+			GLCall(glGetQueryObjectui64v(pass.End, GL_QUERY_RESULT, &end));
+			m_Results.push_back({ pass.Name, (end - begin) * 1e-6 });
+		}
+	}
+
+	for (const Pass& pass : frame.Passes)
+	{
+		m_FreeQueries.push_back(pass.Begin);
+		m_FreeQueries.push_back(pass.End);
+	}
+	frame.Passes.clear();
+}
+
+void GpuProfiler::BeginFrame()
+{
+	if (!m_Supported)
+		return;
+
+	if (m_InPass)
+		EndPass();
+
+	m_Current = (m_Current + 1) % FRAMES_IN_FLIGHT;
+	Resolve(m_Frames[m_Current]);
+}
+
+void GpuProfiler::BeginPass(const char* name)
+{
+	if (!m_Supported)
+		return;
+
+	if (m_InPass)
+		EndPass();
+
+	Pass pass = { name, AcquireQuery(), 0 };
+	GLCall(glQueryCounter(pass.Begin, GL_TIMESTAMP));
+	m_Frames[m_Current].Passes.push_back(pass);
+	m_InPass = true;
+}
+
+void GpuProfiler::EndPass()
+{
+	if (!m_Supported || !m_InPass)
+		return;
+
+	Pass& pass = m_Frames[m_Current].Passes.back();
+	pass.End = AcquireQuery();
+	GLCall(glQueryCounter(pass.End, GL_TIMESTAMP));
+	m_InPass = false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+
+struct GpuPassTiming
+{
+	const char* Name;
+	double Milliseconds;
+};
+
+// GPU time per named pass, measured with timestamp queries around each pass.
+// Queries are read FRAMES_IN_FLIGHT frames after they were issued and only when the
+// driver reports them available, so reading results never stalls the pipeline.
+// A frame whose results are not ready by then is dropped instead of waited for.
+class GpuProfiler
+{
+private:
+	static constexpr unsigned int FRAMES_IN_FLIGHT = 3;
+
+	struct Pass
+	{
+		const char* Name;
+		GLuint Begin;
+		GLuint End;
+	};
+
+	struct Frame
+	{
+		std::vector<Pass> Passes;
+	};
+
+	bool m_Supported;
+	Frame m_Frames[FRAMES_IN_FLIGHT];
+	unsigned int m_Current;
+	bool m_InPass;
+	std::vector<GLuint> m_FreeQueries;
+	std::vector<GpuPassTiming> m_Results;
+
+	GLuint AcquireQuery();
+	void Resolve(Frame& frame);
+public:
+	GpuProfiler();
+	~GpuProfiler();
+
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+	// Starts recording a new frame and collects the oldest one still in flight
+	void BeginFrame();
+
+	// Passes are sequential, name must be a string literal
+	void BeginPass(const char* name);
+	void EndPass();
+
+	// Timings of the most recent frame whose queries have completed
+	inline const std::vector<GpuPassTiming>& GetResults() const { return m_Results; }
+	inline bool IsSupported() const { return m_Supported; }
+};
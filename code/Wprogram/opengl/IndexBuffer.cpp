@@ -1,26 +1,91 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
+#include "GpuMemory.h"
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
-    :m_Count(count)
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, BufferUsage usage)
+    :m_Count(data ? count : 0), m_Capacity(count), m_Usage(usage)
 {
     GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
-
+    Renderer::getInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GetGLBufferUsage(usage)));
+    GpuMemory::Add(GpuMemory::Category::Buffers, (long long)(m_Capacity * sizeof(unsigned int)));
 }
 
 IndexBuffer::~IndexBuffer()
 {
+    Renderer::getInstance().OnBufferDeleted(m_RendererID);
     GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Add(GpuMemory::Category::Buffers, -(long long)(m_Capacity * sizeof(unsigned int)));
 }
 
 void IndexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    Renderer::getInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+    Renderer::getInstance().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void IndexBuffer::SetData(const unsigned int* data, unsigned int count, unsigned int offset)
+{
+    if (count == 0) return;
+
+    BindBufferForWrite(m_RendererID);
+    if (offset == 0 && count >= m_Count)
+    {
+        // Replacing everything: orphan the old storage instead of waiting for draws that still use it
+        unsigned int oldCapacity = m_Capacity;
+        m_Capacity = count > m_Capacity ? GrowBufferCapacity(m_Capacity, count) : m_Capacity;
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, m_Capacity * sizeof(unsigned int), nullptr, GetGLBufferUsage(m_Usage)));
+        GpuMemory::Add(GpuMemory::Category::Buffers, ((long long)m_Capacity - oldCapacity) * (long long)sizeof(unsigned int));
+    }
+    else if (offset + count > m_Capacity)
+    {
+        Reserve(offset + count);
+        BindBufferForWrite(m_RendererID);
+    }
+
+    GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset * sizeof(unsigned int), count * sizeof(unsigned int), data));
+    m_Count = offset + count > m_Count ? offset + count : m_Count;
+}
+
+void IndexBuffer::Reserve(unsigned int capacity)
+{
+    if (capacity <= m_Capacity) return;
+
+    unsigned int oldCapacity = m_Capacity;
+    m_Capacity = GrowBufferCapacity(m_Capacity, capacity);
+    ReallocateBuffer(m_RendererID, m_Count * sizeof(unsigned int), m_Capacity * sizeof(unsigned int), m_Usage);
+    GpuMemory::Add(GpuMemory::Category::Buffers, ((long long)m_Capacity - oldCapacity) * (long long)sizeof(unsigned int));
+}
+
+unsigned int* IndexBuffer::Map(unsigned int offset, unsigned int count, bool unsynchronized)
+{
+    if (offset + count > m_Capacity)
+        Reserve(offset + count);
+
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    if (unsynchronized)
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+
+    BindBufferForWrite(m_RendererID);
+    void* pointer;
+    GLCall(pointer = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset * sizeof(unsigned int), count * sizeof(unsigned int), access));
+    if (pointer)
+        m_Count = offset + count > m_Count ? offset + count : m_Count;
+    return static_cast<unsigned int*>(pointer);
+}
+
+void IndexBuffer::Flush(unsigned int offset, unsigned int count)
+{
+    BindBufferForWrite(m_RendererID);
+    GLCall(glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, offset * sizeof(unsigned int), count * sizeof(unsigned int)));
+}
+
+void IndexBuffer::Unmap()
+{
+    BindBufferForWrite(m_RendererID);
+    GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+}
@@ -1,16 +1,36 @@
 #pragma once
 
+#include "GLBuffer.h"
+
 class IndexBuffer
 {
 private:
 	unsigned int m_RendererID;
 	unsigned int m_Count;
+	unsigned int m_Capacity;
+	BufferUsage m_Usage;
 public:
-	IndexBuffer(const unsigned int* data, unsigned int count);
+	// data may be null to only allocate room for count indices
+	IndexBuffer(const unsigned int* data, unsigned int count, BufferUsage usage = BufferUsage::Static);
 	~IndexBuffer();
 
+	IndexBuffer(const IndexBuffer&) = delete;
+	IndexBuffer& operator=(const IndexBuffer&) = delete;
+
 	void Bind()const;
 	void Unbind() const;
 
+	// Counts and offsets are in indices. Updates never touch the bound vertex array.
+	void SetData(const unsigned int* data, unsigned int count, unsigned int offset = 0);
+	void Reserve(unsigned int capacity);
+
+	unsigned int* Map(unsigned int offset, unsigned int count, bool unsynchronized = false);
+	// offset is relative to the start of the mapped range
+	void Flush(unsigned int offset, unsigned int count);
+	void Unmap();
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 	inline unsigned int GetCount() const { return m_Count; }
-};
\ No newline at end of file
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+	inline BufferUsage GetUsage() const { return m_Usage; }
+};
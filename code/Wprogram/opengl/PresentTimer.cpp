@@ -0,0 +1,83 @@
+#include "PresentTimer.h"
+#include "Renderer.h"
+
+// The two clocks drift slowly, re-measuring the offset once a second is plenty
+static constexpr double CALIBRATION_INTERVAL = 1.0;
+
+PresentTimer::PresentTimer()
+	: m_TimerQueries(glQueryCounter != nullptr && glGetInteger64v != nullptr), m_ClockOffset(0.0), m_LastCalibration(-1.0)
+{
+}
+
+PresentTimer::~PresentTimer()
+{
+	for (const PendingFrame& frame : m_Pending)
+	{
+		GLCall(glDeleteSync(frame.Fence));
+		m_FreeQueries.push_back(frame.Query);
+	}
+	if (!m_FreeQueries.empty())
+	{
+		GLCall(glDeleteQueries((GLsizei)m_FreeQueries.size(), m_FreeQueries.data()));
+	}
+}
+
+void PresentTimer::Mark(unsigned long long frameId)
+{
+	PendingFrame frame = { frameId, 0, nullptr };
+
+	if (m_TimerQueries)
+	{
+		if (m_FreeQueries.empty())
+		{
+			GLCall(glGenQueries(1, &frame.Query));
+		}
+		else
+		{
+			frame.Query = m_FreeQueries.back();
+			m_FreeQueries.pop_back();
+		}
+		GLCall(glQueryCounter(frame.Query, GL_TIMESTAMP));
+	}
+
+	GLCall(frame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	m_Pending.push_back(frame);
+}
+
+void PresentTimer::Calibrate(double cpuNow)
+{
+	GLint64 gpuNow = 0;
+	GLCall(glGetInteger64v(GL_TIMESTAMP, &gpuNow));
+	m_ClockOffset = cpuNow - gpuNow * 1e-9;
+	m_LastCalibration = cpuNow;
+}
+
+void PresentTimer::Poll(double cpuNow, std::vector<Result>& results)
+{
+	if (m_TimerQueries && (m_LastCalibration < 0.0 || cpuNow - m_LastCalibration > CALIBRATION_INTERVAL))
+		Calibrate(cpuNow);
+
+	// Frames complete in order, stop at the first one still in flight
+	while (!m_Pending.empty())
+	{
+		PendingFrame& frame = m_Pending.front();
+
+		GLenum status;
+		GLCall(status = glClientWaitSync(frame.Fence, 0, 0));
+		if (status == GL_TIMEOUT_EXPIRED)
+			break;
+
+		double presentTime = cpuNow;
+		if (m_TimerQueries)
+		{
+			GLuint64 gpuTime = 0;
+			GLCall(glGetQueryObjectui64v(frame.Query, GL_QUERY_RESULT, &gpuTime));
+			presentTime = gpuTime * 1e-9 + m_ClockOffset;
+			m_FreeQueries.push_back(frame.Query);
+		}
+
+		GLCall(glDeleteSync(frame.Fence));
+		results.push_back({ frame.FrameId, presentTime });
+		m_Pending.pop_front();
+	}
+}
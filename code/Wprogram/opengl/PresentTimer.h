@@ -0,0 +1,47 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <glad/glad.h>
+
+// Estimates when frames reached the display.
+// Mark() right after SwapBuffers records a GPU timestamp and a fence behind the swap. Once the
+// fence has signaled the timestamp is read without stalling and mapped onto the caller's clock.
+// Without timer queries the time the fence was seen signaled is used instead.
+class PresentTimer
+{
+public:
+	struct Result
+	{
+		unsigned long long FrameId;
+		double PresentTime;
+	};
+
+private:
+	struct PendingFrame
+	{
+		unsigned long long FrameId;
+		GLuint Query;
+		GLsync Fence;
+	};
+
+	bool m_TimerQueries;
+	std::deque<PendingFrame> m_Pending;
+	std::vector<GLuint> m_FreeQueries;
+
+	// Caller clock minus GPU clock, in seconds
+	double m_ClockOffset;
+	double m_LastCalibration;
+
+	void Calibrate(double cpuNow);
+public:
+	PresentTimer();
+	~PresentTimer();
+
+	PresentTimer(const PresentTimer&) = delete;
+	PresentTimer& operator=(const PresentTimer&) = delete;
+
+	void Mark(unsigned long long frameId);
+	// Appends every frame whose present time is known by now, oldest first
+	void Poll(double cpuNow, std::vector<Result>& results);
+};
@@ -1,5 +1,8 @@
 #include "Renderer.h"
+#include "GLExtensions.h"
+#include "Texture.h"
 #include<iostream>
+#include<algorithm>
 
 void GLClearError()
 {
@@ -15,22 +18,386 @@ bool GLLogCall(const char* function, const char* file, int line)
     return true;
 }
 
-Renderer::Renderer() {}
+struct GLCallSite
+{
+    const char* Function = nullptr;
+    const char* File = nullptr;
+    int Line = 0;
+    bool ErrorRaised = false;
+};
+
+static thread_local GLCallSite s_CallSite;
+static bool s_DebugOutput = false;
+
+static void APIENTRY GLDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+{
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+        return;
+
+    std::cout << "[OpenGL Debug]: " << message;
+    if (s_CallSite.Function)
+        std::cout << ": " << s_CallSite.Function << ": " << s_CallSite.File << ": " << s_CallSite.Line;
+    std::cout << std::endl;
+
+    if (type == GL_DEBUG_TYPE_ERROR)
+        s_CallSite.ErrorRaised = true;
+}
+
+void GLBeginCall(const char* function, const char* file, int line)
+{
+    s_CallSite.Function = function;
+    s_CallSite.File = file;
+    s_CallSite.Line = line;
+    // Errors from GL calls made outside GLCall (ImGui, GLFW) must not fail this one
+    s_CallSite.ErrorRaised = false;
+
+    if (!s_DebugOutput)
+        GLClearError();
+}
+
+bool GLEndCall()
+{
+    bool ok = s_DebugOutput
+        ? !s_CallSite.ErrorRaised
+        : GLLogCall(s_CallSite.Function, s_CallSite.File, s_CallSite.Line);
+
+    // Messages arriving between GLCalls are printed without a call site
+    s_CallSite = GLCallSite();
+    return ok;
+}
+
+void GLInitDebugOutput()
+{
+#ifdef WHITEBOARD_GL_DEBUG
+    const GLExtensions& extensions = GetGLExtensions();
+    if (!extensions.DebugOutput)
+    {
+        std::cout << "KHR_debug is not available, falling back to glGetError polling" << std::endl;
+        return;
+    }
+
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT))
+        std::cout << "Warning: not a debug context, some drivers will not report errors" << std::endl;
+
+    glEnable(GL_DEBUG_OUTPUT);
+    // Synchronous delivery keeps the recorded call site accurate
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    extensions.DebugMessageCallback(GLDebugMessage, nullptr);
+    extensions.DebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+    s_DebugOutput = true;
+#endif
+}
+
+Renderer::Renderer()
+{
+    InvalidateState();
+}
 
 Renderer& Renderer::getInstance() {
     static Renderer instance;
     return instance;
 }
 
-void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader)const
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader)
 {
     shader.Bind();
     va.Bind();
     ib.Bind();
     GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+    m_BatchStats.DrawCalls++;
+}
+
+unsigned long long Renderer::MakeSortKey(unsigned int layer, const Shader* shader, const Texture* texture, BlendMode blend)
+{
+    unsigned long long key = 0;
+    key |= (unsigned long long)(layer & 0xFF) << 56;
+    key |= (unsigned long long)((shader ? shader->GetRendererID() : 0) & 0xFFFF) << 40;
+    key |= (unsigned long long)((texture ? texture->GetRendererID() : 0) & 0xFFFFFF) << 16;
+    key |= (unsigned long long)blend << 8;
+    return key;
+}
+
+void Renderer::Submit(const DrawPacket& packet)
+{
+    m_Queue.push_back(packet);
+    m_BatchStats.Packets++;
+}
+
+bool Renderer::SameState(const DrawPacket& a, const DrawPacket& b)
+{
+    return a.VA == b.VA && a.IB == b.IB && a.Program == b.Program && a.Tex == b.Tex && a.Blend == b.Blend;
+}
+
+void Renderer::ApplyPacketState(const DrawPacket& packet)
+{
+    packet.Program->Bind();
+    packet.VA->Bind();
+    packet.IB->Bind();
+    if (packet.Tex)
+        packet.Tex->Bind(0);
+
+    SetBlend(packet.Blend != BlendMode::None);
+    if (packet.Blend == BlendMode::Alpha)
+        SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void Renderer::Flush()
+{
+    // Stable so packets with equal keys keep submission order, which keeps instance ranges mergeable
+    std::stable_sort(m_Queue.begin(), m_Queue.end(), [](const DrawPacket& a, const DrawPacket& b) {
+        return a.SortKey < b.SortKey;
+    });
+
+    size_t i = 0;
+    while (i < m_Queue.size())
+    {
+        const DrawPacket& first = m_Queue[i];
+        unsigned int indexCount = first.IndexCount ? first.IndexCount : first.IB->GetCount();
+        ApplyPacketState(first);
+
+        size_t next = i + 1;
+        if (first.InstanceCount > 0)
+        {
+            unsigned int instanceCount = first.InstanceCount;
+            while (next < m_Queue.size() && SameState(first, m_Queue[next]) &&
+                m_Queue[next].InstanceCount > 0 &&
+                m_Queue[next].IndexCount == first.IndexCount && m_Queue[next].IndexOffset == first.IndexOffset &&
+                m_Queue[next].FirstInstance == first.FirstInstance + instanceCount)
+            {
+                instanceCount += m_Queue[next].InstanceCount;
+                next++;
+            }
+
+            first.VA->SetInstanceBase(first.FirstInstance);
+            GLCall(glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT,
+                (const void*)(first.IndexOffset * sizeof(unsigned int)), instanceCount));
+        }
+        else
+        {
+            m_MultiDrawCounts.clear();
+            m_MultiDrawOffsets.clear();
+            m_MultiDrawCounts.push_back(indexCount);
+            m_MultiDrawOffsets.push_back((const void*)(first.IndexOffset * sizeof(unsigned int)));
+            while (next < m_Queue.size() && SameState(first, m_Queue[next]) && m_Queue[next].InstanceCount == 0)
+            {
+                const DrawPacket& packet = m_Queue[next];
+                m_MultiDrawCounts.push_back(packet.IndexCount ? packet.IndexCount : packet.IB->GetCount());
+                m_MultiDrawOffsets.push_back((const void*)(packet.IndexOffset * sizeof(unsigned int)));
+                next++;
+            }
+
+            if (m_MultiDrawCounts.size() == 1)
+            {
+                GLCall(glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, m_MultiDrawOffsets[0]));
+            }
+            else
+            {
+                GLCall(glMultiDrawElements(GL_TRIANGLES, m_MultiDrawCounts.data(), GL_UNSIGNED_INT,
+                    m_MultiDrawOffsets.data(), (GLsizei)m_MultiDrawCounts.size()));
+            }
+        }
+
+        m_BatchStats.DrawCalls++;
+        i = next;
+    }
+
+    m_Queue.clear();
 }
 
 void Renderer::Clear()
 {
     GLCall(glClear(GL_COLOR_BUFFER_BIT));
+}
+
+bool Renderer::Changed(unsigned int& shadow, unsigned int value)
+{
+    if (shadow == value)
+    {
+        m_Stats.Skipped++;
+        return false;
+    }
+
+    shadow = value;
+    m_Stats.Issued++;
+    return true;
+}
+
+void Renderer::BindProgram(unsigned int program)
+{
+    if (Changed(m_Program, program))
+    {
+        GLCall(glUseProgram(program));
+    }
+}
+
+void Renderer::BindVertexArray(unsigned int vertexArray)
+{
+    if (Changed(m_VertexArray, vertexArray))
+    {
+        GLCall(glBindVertexArray(vertexArray));
+    }
+}
+
+void Renderer::BindBuffer(unsigned int target, unsigned int buffer)
+{
+    unsigned int* shadow = nullptr;
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER: shadow = &m_ArrayBuffer; break;
+        case GL_UNIFORM_BUFFER: shadow = &m_UniformBuffer; break;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            if (m_VertexArray != UNKNOWN)
+            {
+                auto it = m_ElementBuffers.try_emplace(m_VertexArray, UNKNOWN).first;
+                shadow = &it->second;
+            }
+            break;
+    }
+
+    if (shadow == nullptr)
+    {
+        m_Stats.Issued++;
+        GLCall(glBindBuffer(target, buffer));
+        return;
+    }
+
+    if (Changed(*shadow, buffer))
+    {
+        GLCall(glBindBuffer(target, buffer));
+    }
+}
+
+void Renderer::BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+{
+    if (target != GL_UNIFORM_BUFFER || index >= MAX_UNIFORM_BINDINGS)
+    {
+        m_Stats.Issued++;
+        GLCall(glBindBufferBase(target, index, buffer));
+        return;
+    }
+
+    if (Changed(m_UniformBindings[index], buffer))
+    {
+        GLCall(glBindBufferBase(target, index, buffer));
+        // glBindBufferBase also replaces the generic binding
+        m_UniformBuffer = buffer;
+    }
+}
+
+void Renderer::BindTexture(unsigned int slot, unsigned int texture, unsigned int target)
+{
+    if (slot >= MAX_TEXTURE_SLOTS)
+    {
+        m_Stats.Issued += 2;
+        m_ActiveTextureSlot = UNKNOWN;
+        GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+        GLCall(glBindTexture(target, texture));
+        return;
+    }
+
+    // Texture uploads act on the active slot, so it is always made current
+    if (Changed(m_ActiveTextureSlot, slot))
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    }
+
+    if (target != GL_TEXTURE_2D)
+    {
+        m_Stats.Issued++;
+        GLCall(glBindTexture(target, texture));
+        return;
+    }
+
+    if (Changed(m_Textures[slot], texture))
+    {
+        GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+    }
+}
+
+void Renderer::SetBlend(bool enabled)
+{
+    if (m_BlendEnabled == (int)enabled)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+
+    m_BlendEnabled = enabled;
+    m_Stats.Issued++;
+    if (enabled)
+    {
+        GLCall(glEnable(GL_BLEND));
+    }
+    else
+    {
+        GLCall(glDisable(GL_BLEND));
+    }
+}
+
+void Renderer::SetBlendFunc(unsigned int src, unsigned int dst)
+{
+    if (m_BlendSrc == src && m_BlendDst == dst)
+    {
+        m_Stats.Skipped++;
+        return;
+    }
+
+    m_BlendSrc = src;
+    m_BlendDst = dst;
+    m_Stats.Issued++;
+    GLCall(glBlendFunc(src, dst));
+}
+
+void Renderer::OnProgramDeleted(unsigned int program)
+{
+    if (m_Program == program)
+        m_Program = UNKNOWN;
+}
+
+void Renderer::OnVertexArrayDeleted(unsigned int vertexArray)
+{
+    m_ElementBuffers.erase(vertexArray);
+    if (m_VertexArray == vertexArray)
+        m_VertexArray = UNKNOWN;
+}
+
+void Renderer::OnBufferDeleted(unsigned int buffer)
+{
+    if (m_ArrayBuffer == buffer)
+        m_ArrayBuffer = UNKNOWN;
+    if (m_UniformBuffer == buffer)
+        m_UniformBuffer = UNKNOWN;
+    for (unsigned int& binding : m_UniformBindings)
+        if (binding == buffer)
+            binding = UNKNOWN;
+    for (auto& element : m_ElementBuffers)
+        if (element.second == buffer)
+            element.second = UNKNOWN;
+}
+
+void Renderer::OnTextureDeleted(unsigned int texture)
+{
+    for (unsigned int& bound : m_Textures)
+        if (bound == texture)
+            bound = UNKNOWN;
+}
+
+void Renderer::InvalidateState()
+{
+    m_Program = UNKNOWN;
+    m_VertexArray = UNKNOWN;
+    m_ArrayBuffer = UNKNOWN;
+    m_UniformBuffer = UNKNOWN;
+    for (unsigned int& binding : m_UniformBindings)
+        binding = UNKNOWN;
+    m_ElementBuffers.clear();
+    m_ActiveTextureSlot = UNKNOWN;
+    for (unsigned int& texture : m_Textures)
+        texture = UNKNOWN;
+    m_BlendEnabled = -1;
+    m_BlendSrc = UNKNOWN;
+    m_BlendDst = UNKNOWN;
 }
\ No newline at end of file
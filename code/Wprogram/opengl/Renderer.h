@@ -1,28 +1,149 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <unordered_map>
+#include <vector>
 
 #include "VertexArray.h";
 #include "IndexBuffer.h";
 #include "Shader.h";
 
-#define ASSERT(x) if(!(x)) __debugbreak();
-#define GLCall(x) GLClearError();\
+#if defined(_MSC_VER)
+#define DEBUG_BREAK() __debugbreak()
+#else
+#include <csignal>
+#define DEBUG_BREAK() std::raise(SIGTRAP)
+#endif
+
+// WHITEBOARD_GL_DEBUG is set for Debug builds. Release builds issue GL calls
+// without any error checking. Debug builds record the call site of each GLCall
+// and let the KHR_debug callback report errors against it; drivers without
+// KHR_debug fall back to polling glGetError around every call.
+#ifdef WHITEBOARD_GL_DEBUG
+#define ASSERT(x) if(!(x)) DEBUG_BREAK();
+#define GLCall(x) GLBeginCall(#x,__FILE__,__LINE__);\
 	x;\
-	ASSERT(GLLogCall(#x,__FILE__,__LINE__));
+	ASSERT(GLEndCall());
+#else
+#define ASSERT(x)
+#define GLCall(x) x;
+#endif
 
 void GLClearError();
 bool GLLogCall(const char* function, const char* file, int line);
 
+void GLBeginCall(const char* function, const char* file, int line);
+bool GLEndCall();
+
+// Installs the debug message callback when the driver supports it, call once after LoadGLExtensions()
+void GLInitDebugOutput();
+
+struct StateChangeStats
+{
+	unsigned long long Issued = 0;
+	unsigned long long Skipped = 0;
+};
+
+class Texture;
+
+enum class BlendMode : unsigned char
+{
+	None = 0,
+	Alpha = 1
+};
+
+// One queued draw. Packets with the same state are merged at Flush():
+// plain draws into a single glMultiDrawElements, instanced draws whose
+// instance ranges follow each other into a single glDrawElementsInstanced.
+struct DrawPacket
+{
+	unsigned long long SortKey = 0;
+	const VertexArray* VA = nullptr;
+	const IndexBuffer* IB = nullptr;
+	const Shader* Program = nullptr;
+	const Texture* Tex = nullptr;
+	BlendMode Blend = BlendMode::Alpha;
+	unsigned int IndexCount = 0;	// 0 draws the whole index buffer
+	unsigned int IndexOffset = 0;
+	unsigned int FirstInstance = 0;
+	unsigned int InstanceCount = 0;	// 0 is a non-instanced draw
+};
+
+struct BatchStats
+{
+	unsigned long long Packets = 0;
+	unsigned long long DrawCalls = 0;
+};
+
 class Renderer {
 private:
+	static constexpr unsigned int UNKNOWN = 0xFFFFFFFF;
+	static constexpr unsigned int MAX_TEXTURE_SLOTS = 32;
+	static constexpr unsigned int MAX_UNIFORM_BINDINGS = 16;
+
+	// Shadow copy of the bound GL state, UNKNOWN forces the next call through
+	unsigned int m_Program;
+	unsigned int m_VertexArray;
+	unsigned int m_ArrayBuffer;
+	unsigned int m_UniformBuffer;
+	unsigned int m_UniformBindings[MAX_UNIFORM_BINDINGS];
+	// The element buffer binding is part of the VAO state
+	std::unordered_map<unsigned int, unsigned int> m_ElementBuffers;
+	unsigned int m_ActiveTextureSlot;
+	unsigned int m_Textures[MAX_TEXTURE_SLOTS];
+	int m_BlendEnabled;
+	unsigned int m_BlendSrc;
+	unsigned int m_BlendDst;
+
+	StateChangeStats m_Stats;
+	BatchStats m_BatchStats;
+
+	std::vector<DrawPacket> m_Queue;
+	std::vector<GLsizei> m_MultiDrawCounts;
+	std::vector<const void*> m_MultiDrawOffsets;
+
 	Renderer();
 
 	Renderer(const Renderer&) = delete;
 	Renderer& operator =(const Renderer&) = delete;
 
+	bool Changed(unsigned int& shadow, unsigned int value);
+
+	void ApplyPacketState(const DrawPacket& packet);
+	static bool SameState(const DrawPacket& a, const DrawPacket& b);
+
 public:
 	static Renderer& getInstance();
-	void Draw(const VertexArray& va,const IndexBuffer&ib,const Shader& shader)const;
+	void Draw(const VertexArray& va,const IndexBuffer&ib,const Shader& shader);
 	void Clear();
+
+	// Layer sorts first, then shader, texture and blend mode so state changes are grouped
+	static unsigned long long MakeSortKey(unsigned int layer, const Shader* shader, const Texture* texture, BlendMode blend);
+	void Submit(const DrawPacket& packet);
+	void Flush();
+
+	// Every bind in GraphicsEngine goes through these so redundant calls are skipped
+	void BindProgram(unsigned int program);
+	void BindVertexArray(unsigned int vertexArray);
+	void BindBuffer(unsigned int target, unsigned int buffer);
+	void BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+	// Only GL_TEXTURE_2D bindings are tracked, other targets are always issued
+	void BindTexture(unsigned int slot, unsigned int texture, unsigned int target = GL_TEXTURE_2D);
+	void SetBlend(bool enabled);
+	void SetBlendFunc(unsigned int src, unsigned int dst);
+
+	// Deleting a bound object resets its binding to 0 and the name may be reused
+	void OnProgramDeleted(unsigned int program);
+	void OnVertexArrayDeleted(unsigned int vertexArray);
+	void OnBufferDeleted(unsigned int buffer);
+	void OnTextureDeleted(unsigned int texture);
+
+	// Call after code outside GraphicsEngine touched GL state without restoring it
+	void InvalidateState();
+
+	inline const StateChangeStats& GetStateChangeStats() const { return m_Stats; }
+	inline void ResetStateChangeStats() { m_Stats = StateChangeStats(); }
+
+	inline const BatchStats& GetBatchStats() const { return m_BatchStats; }
+	inline void ResetBatchStats() { m_BatchStats = BatchStats(); }
 };
\ No newline at end of file
@@ -3,51 +3,95 @@
 #include<iostream>
 #include<fstream>
 #include<string>
-#include<sstream>
+#include<string_view>
+#include<vector>
+#include<cstring>
+#include<cstdio>
+#include<filesystem>
 
 #include "Renderer.h"
+#include "GLExtensions.h"
 
-Shader::Shader(const std::string& filepath)
-	:m_FilePath(filepath), m_RendererID(0)
+Shader::Shader(const std::string& filepath, const std::string& cacheDirectory)
+	:m_FilePath(filepath), m_CacheDirectory(cacheDirectory), m_RendererID(0)
 {//"../opengl/shaders/Basic.shader"
-    ShaderProgramSource source = ParseShader(filepath);
-    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    std::string source = ReadShaderFile(filepath);
+
+    unsigned long long key = 0;
+    bool useCache = !m_CacheDirectory.empty() && GetGLExtensions().ProgramBinary;
+    if (useCache)
+    {
+        key = GetProgramCacheKey(source);
+        m_RendererID = LoadProgramBinary(key);
+        if (m_RendererID != 0)
+            return;
+    }
+
+    ShaderProgramSource programSource = ParseShader(source);
+    m_RendererID = CreateShader(programSource.VertexSource, programSource.FragmentSource);
+
+    if (useCache)
+        SaveProgramBinary(m_RendererID, key);
 }
 
 Shader::~Shader()
 {
+    Renderer::getInstance().OnProgramDeleted(m_RendererID);
     GLCall(glDeleteProgram(m_RendererID));
 }
 
-ShaderProgramSource Shader::ParseShader(const std::string& filepath)
+std::string Shader::ReadShaderFile(const std::string& filepath)
 {
-    std::ifstream stream(filepath);
-    std::cout << filepath << std::endl;
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream)
+    {
+        std::cout << "Failed to open shader " << filepath << std::endl;
+        return "";
+    }
+
+    std::string source;
+    stream.seekg(0, std::ios::end);
+    source.resize((size_t)stream.tellg());
+    stream.seekg(0, std::ios::beg);
+    stream.read(&source[0], source.size());
+
+    return source;
+}
 
+ShaderProgramSource Shader::ParseShader(const std::string& source)
+{
     enum class ShaderType
     {
         NONE = -1, VERTEX = 0, FRAGMENT = 1
     };
 
-    std::string line;
-    std::stringstream ss[2];
+    std::string result[2];
     ShaderType type = ShaderType::NONE;
-    while (getline(stream, line))
+    size_t lineStart = 0;
+    while (lineStart < source.size())
     {
-        if (line.find("#shader") != std::string::npos)
+        size_t lineEnd = source.find('\n', lineStart);
+        if (lineEnd == std::string::npos)
+            lineEnd = source.size();
+
+        std::string_view line(source.data() + lineStart, lineEnd - lineStart);
+        if (line.find("#shader") != std::string_view::npos)
         {
-            if (line.find("vertex") != std::string::npos)
+            if (line.find("vertex") != std::string_view::npos)
                 type = ShaderType::VERTEX;
-            else if (line.find("fragment") != std::string::npos)
+            else if (line.find("fragment") != std::string_view::npos)
                 type = ShaderType::FRAGMENT;
         }
-        else
+        else if (type != ShaderType::NONE)
         {
-            ss[(int)type] << line << "\n";
+            result[(int)type].append(line);
+            result[(int)type] += '\n';
         }
+
+        lineStart = lineEnd + 1;
     }
 
-    return{ ss[0].str(),ss[1].str() };
+    return{ result[0],result[1] };
 }
 
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
@@ -83,6 +127,11 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
     unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
+    if (!m_CacheDirectory.empty() && GetGLExtensions().ProgramBinary)
+    {
+        GLCall(GetGLExtensions().ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
     GLCall(glAttachShader(program, vs));
     GLCall(glAttachShader(program, fs));
     GLCall(glLinkProgram(program));
@@ -94,14 +143,118 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
     return program;;
 }
 
+// Program binaries are only valid for the exact driver that produced them,
+// so the driver strings are part of the key next to the shader source
+unsigned long long Shader::GetProgramCacheKey(const std::string& source)
+{
+    const char* vendor = (const char*)glGetString(GL_VENDOR);
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    const char* version = (const char*)glGetString(GL_VERSION);
+
+    // FNV-1a
+    unsigned long long hash = 14695981039346656037ull;
+    auto mix = [&hash](const char* data, size_t size) {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ull;
+        }
+        // separator so "ab"+"c" and "a"+"bc" differ
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+    };
+
+    mix(source.data(), source.size());
+    mix(vendor ? vendor : "", vendor ? strlen(vendor) : 0);
+    mix(renderer ? renderer : "", renderer ? strlen(renderer) : 0);
+    mix(version ? version : "", version ? strlen(version) : 0);
+
+    return hash;
+}
+
+std::string Shader::GetProgramCachePath(unsigned long long key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", key);
+    return (std::filesystem::path(m_CacheDirectory) / name).string();
+}
+
+struct ProgramBinaryHeader
+{
+    unsigned int Magic;
+    unsigned int Format;
+    unsigned long long Key;
+    unsigned int Length;
+};
+
+static const unsigned int PROGRAM_BINARY_MAGIC = 0x42505657; // "WVPB"
+
+unsigned int Shader::LoadProgramBinary(unsigned long long key)
+{
+    std::ifstream stream(GetProgramCachePath(key), std::ios::binary);
+    if (!stream)
+        return 0;
+
+    ProgramBinaryHeader header;
+    if (!stream.read((char*)&header, sizeof(header)) ||
+        header.Magic != PROGRAM_BINARY_MAGIC || header.Key != key || header.Length == 0)
+        return 0;
+
+    std::vector<char> binary(header.Length);
+    if (!stream.read(binary.data(), binary.size()))
+        return 0;
+
+    GLCall(unsigned int program = glCreateProgram());
+    GLCall(GetGLExtensions().ProgramBinaryLoad(program, header.Format, binary.data(), (GLsizei)binary.size()));
+
+    // The driver may reject a binary it produced itself, e.g. after an update
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+    {
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+
+    return program;
+}
+
+void Shader::SaveProgramBinary(unsigned int program, unsigned long long key)
+{
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+        return;
+
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLCall(GetGLExtensions().GetProgramBinary(program, length, &length, &format, binary.data()));
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_CacheDirectory, ec);
+
+    std::ofstream stream(GetProgramCachePath(key), std::ios::binary | std::ios::trunc);
+    if (!stream)
+        return;
+
+    ProgramBinaryHeader header = { PROGRAM_BINARY_MAGIC, format, key, (unsigned int)length };
+    stream.write((const char*)&header, sizeof(header));
+    stream.write(binary.data(), length);
+}
+
 void Shader::Bind() const
 {
-    GLCall(glUseProgram(m_RendererID));
+    Renderer::getInstance().BindProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-    GLCall(glUseProgram(0));
+    Renderer::getInstance().BindProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int value)
@@ -129,6 +282,49 @@ void Shader::SetUniformMat4f(const std::string& name, const glm::mat4&Matrix)
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &Matrix[0][0]));
 }
 
+void Shader::SetUniform(const Uniform<int>& uniform, int value) const
+{
+    GLCall(glUniform1i(uniform.GetLocation(), value));
+}
+
+void Shader::SetUniform(const Uniform<float>& uniform, float value) const
+{
+    GLCall(glUniform1f(uniform.GetLocation(), value));
+}
+
+void Shader::SetUniform(const Uniform<glm::vec2>& uniform, const glm::vec2& value) const
+{
+    GLCall(glUniform2f(uniform.GetLocation(), value.x, value.y));
+}
+
+void Shader::SetUniform(const Uniform<glm::vec3>& uniform, const glm::vec3& value) const
+{
+    GLCall(glUniform3f(uniform.GetLocation(), value.x, value.y, value.z));
+}
+
+void Shader::SetUniform(const Uniform<glm::vec4>& uniform, const glm::vec4& value) const
+{
+    GLCall(glUniform4f(uniform.GetLocation(), value.x, value.y, value.z, value.w));
+}
+
+void Shader::SetUniform(const Uniform<glm::mat4>& uniform, const glm::mat4& value) const
+{
+    GLCall(glUniformMatrix4fv(uniform.GetLocation(), 1, GL_FALSE, &value[0][0]));
+}
+
+bool Shader::BindUniformBlock(const std::string& blockName, unsigned int binding)
+{
+    GLCall(unsigned int index = glGetUniformBlockIndex(m_RendererID, blockName.c_str()));
+    if (index == GL_INVALID_INDEX)
+    {
+        std::cout << "Warning: uniform block " << blockName << " doesn't exist!" << std::endl;
+        return false;
+    }
+
+    GLCall(glUniformBlockBinding(m_RendererID, index, binding));
+    return true;
+}
+
 int Shader::GetUniformLocation(const std::string& name)
 {
     if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
@@ -11,29 +11,66 @@ struct ShaderProgramSource
 	std::string FragmentSource;
 };
 
+// Uniform location resolved once; the type picks the matching glUniform* call
+template<typename T>
+class Uniform
+{
+private:
+	int m_Location;
+public:
+	Uniform() :m_Location(-1) {}
+	explicit Uniform(int location) :m_Location(location) {}
+
+	inline int GetLocation() const { return m_Location; }
+	inline bool IsValid() const { return m_Location != -1; }
+};
+
 class Shader
 {
 private:
 	std::string m_FilePath;
+	std::string m_CacheDirectory;
 	unsigned int m_RendererID;
 	std::unordered_map<std::string, int> m_UniformLocationCache;
 public:
-	Shader(const std::string& filepath);
+	// When cacheDirectory is not empty the linked program binary is cached there
+	// and reused on the next launch as long as the source and the driver did not change
+	Shader(const std::string& filepath, const std::string& cacheDirectory = "");
 	~Shader();
 
 	void Bind() const;
 	void Unbind() const;
 
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
 	void SetUniform1i(const std::string& name, int value);
 	void SetUniform1f(const std::string& name, float value);
 	void SetUniform2f(const std::string& name, float v1,float v2);
 	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
 	void SetUniformMat4f(const std::string& name,const glm::mat4&Matrix);
 
+	template<typename T>
+	Uniform<T> GetUniform(const std::string& name) { return Uniform<T>(GetUniformLocation(name)); }
+
+	void SetUniform(const Uniform<int>& uniform, int value) const;
+	void SetUniform(const Uniform<float>& uniform, float value) const;
+	void SetUniform(const Uniform<glm::vec2>& uniform, const glm::vec2& value) const;
+	void SetUniform(const Uniform<glm::vec3>& uniform, const glm::vec3& value) const;
+	void SetUniform(const Uniform<glm::vec4>& uniform, const glm::vec4& value) const;
+	void SetUniform(const Uniform<glm::mat4>& uniform, const glm::mat4& value) const;
+
+	// Connects a uniform block of this program to a UniformBuffer binding point
+	bool BindUniformBlock(const std::string& blockName, unsigned int binding);
+
 private:
 	bool CompileShader();
-	ShaderProgramSource ParseShader(const std::string& filepath);
+	std::string ReadShaderFile(const std::string& filepath);
+	ShaderProgramSource ParseShader(const std::string& source);
 	unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+	unsigned long long GetProgramCacheKey(const std::string& source);
+	std::string GetProgramCachePath(unsigned long long key);
+	unsigned int LoadProgramBinary(unsigned long long key);
+	void SaveProgramBinary(unsigned int program, unsigned long long key);
 	unsigned int CompileShader(unsigned int type, const std::string& source);
 	int GetUniformLocation(const std::string& name);
 };
\ No newline at end of file
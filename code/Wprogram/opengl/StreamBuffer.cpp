@@ -0,0 +1,129 @@
+#include "StreamBuffer.h"
+#include <cstring>
+#include "Renderer.h"
+
+StreamBuffer::StreamBuffer(unsigned int capacity)
+    :m_RunOffset(0), m_RunSize(0)
+{
+    m_Buffer = new VertexBuffer(nullptr, capacity, BufferUsage::Stream);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    DropFences();
+    delete m_Buffer;
+}
+
+void StreamBuffer::BeginRun(unsigned int alignment)
+{
+    unsigned int head = m_RunOffset + m_RunSize;
+    head = (head + alignment - 1) / alignment * alignment;
+
+    // Wrap early rather than starting a run that is about to run out of room
+    unsigned int capacity = m_Buffer->GetCapacity();
+    if (head >= capacity - capacity / 4)
+        head = 0;
+
+    m_RunOffset = head;
+    m_RunSize = 0;
+}
+
+void StreamBuffer::Append(const void* data, unsigned int size)
+{
+    if (size == 0) return;
+
+    if (m_RunOffset + m_RunSize + size > m_Buffer->GetCapacity())
+    {
+        // Move the run back to the start when it fits there without overlapping itself
+        if (m_RunSize + size <= m_RunOffset)
+        {
+            Renderer::getInstance().BindBuffer(GL_COPY_READ_BUFFER, m_Buffer->GetRendererID());
+            Renderer::getInstance().BindBuffer(GL_COPY_WRITE_BUFFER, m_Buffer->GetRendererID());
+            GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, m_RunOffset, 0, m_RunSize));
+            m_RunOffset = 0;
+        }
+        else
+        {
+            // Growing re-specifies the storage, so draws reading the old ranges no longer matter
+            m_Buffer->Reserve(m_RunOffset + m_RunSize + size);
+            DropFences();
+        }
+    }
+
+    unsigned int offset = m_RunOffset + m_RunSize;
+    WaitForRange(offset, offset + size);
+
+    void* destination = m_Buffer->Map(offset, size, true);
+    if (destination)
+    {
+        memcpy(destination, data, size);
+        m_Buffer->Flush(0, size);
+        m_Buffer->Unmap();
+    }
+    else
+    {
+        m_Buffer->SetData(data, size, offset);
+    }
+
+    m_RunSize += size;
+}
+
+void StreamBuffer::Fence()
+{
+    // Drop fences the GPU has already passed
+    for (size_t i = 0; i < m_Fences.size();)
+    {
+        GLenum status;
+        GLCall(status = glClientWaitSync(m_Fences[i].Sync, 0, 0));
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+        {
+            GLCall(glDeleteSync(m_Fences[i].Sync));
+            m_Fences[i] = m_Fences.back();
+            m_Fences.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    if (m_RunSize == 0) return;
+
+    PendingFence fence;
+    GLCall(fence.Sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    fence.Begin = m_RunOffset;
+    fence.End = m_RunOffset + m_RunSize;
+    m_Fences.push_back(fence);
+}
+
+void StreamBuffer::WaitForRange(unsigned int begin, unsigned int end)
+{
+    for (size_t i = 0; i < m_Fences.size();)
+    {
+        const PendingFence& fence = m_Fences[i];
+        if (fence.Begin >= end || fence.End <= begin)
+        {
+            i++;
+            continue;
+        }
+
+        GLenum status;
+        do
+        {
+            GLCall(status = glClientWaitSync(fence.Sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+        } while (status == GL_TIMEOUT_EXPIRED);
+
+        GLCall(glDeleteSync(fence.Sync));
+        m_Fences[i] = m_Fences.back();
+        m_Fences.pop_back();
+    }
+}
+
+void StreamBuffer::DropFences()
+{
+    for (const PendingFence& fence : m_Fences)
+    {
+        GLCall(glDeleteSync(fence.Sync));
+    }
+    m_Fences.clear();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+#include "VertexBuffer.h"
+
+// Vertex buffer that is filled incrementally, one run at a time.
+// A run is a contiguous range that only grows until the next BeginRun. Appends write
+// straight into the buffer through an unsynchronized mapping, fences keep them from
+// overwriting ranges the GPU may still be reading.
+class StreamBuffer
+{
+private:
+	struct PendingFence
+	{
+		GLsync Sync;
+		unsigned int Begin;
+		unsigned int End;
+	};
+
+	VertexBuffer* m_Buffer;
+	unsigned int m_RunOffset;
+	unsigned int m_RunSize;
+	std::vector<PendingFence> m_Fences;
+
+	void WaitForRange(unsigned int begin, unsigned int end);
+	void DropFences();
+public:
+	StreamBuffer(unsigned int capacity);
+	~StreamBuffer();
+
+	StreamBuffer(const StreamBuffer&) = delete;
+	StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+	// Starts an empty run after the previous one, offset is a multiple of alignment
+	void BeginRun(unsigned int alignment);
+	void Append(const void* data, unsigned int size);
+	// Call after the draws reading the current run have been issued
+	void Fence();
+
+	inline unsigned int GetRunOffset() const { return m_RunOffset; }
+	inline unsigned int GetRunSize() const { return m_RunSize; }
+	// Growing keeps the same buffer, vertex arrays only need to attach it once
+	inline const VertexBuffer& GetBuffer() const { return *m_Buffer; }
+};
@@ -1,15 +1,16 @@
 #include "Texture.h"
+#include "GpuMemory.h"
 
 #include "stb_image.h"
 
 Texture::Texture(const std::string& path)
-	:m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
+	:m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0), m_MemoryBytes(0)
 {
 	stbi_set_flip_vertically_on_load(1);
 	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
 
 	GLCall(glGenTextures(1, &m_RendererID));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	Renderer::getInstance().BindTexture(0, m_RendererID);
 
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
@@ -17,24 +18,65 @@ Texture::Texture(const std::string& path)
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 	
 	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	Renderer::getInstance().BindTexture(0, 0);
+
+	m_MemoryBytes = (long long)m_Width * m_Height * 4;
+	GpuMemory::Add(GpuMemory::Category::Textures, m_MemoryBytes);
 
 	if (m_LocalBuffer)
 		stbi_image_free(m_LocalBuffer);
 }
 
+Texture::Texture(int width, int height, bool mipmaps)
+	:m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4), m_MemoryBytes(0)
+{
+	GLCall(glGenTextures(1, &m_RendererID));
+	Renderer::getInstance().BindTexture(0, m_RendererID);
+
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	if (!mipmaps)
+	{
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+	}
+
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	Renderer::getInstance().BindTexture(0, 0);
+
+	// A full mip chain adds a third on top of the base level
+	m_MemoryBytes = (long long)m_Width * m_Height * 4;
+	if (mipmaps)
+		m_MemoryBytes += m_MemoryBytes / 3;
+	GpuMemory::Add(GpuMemory::Category::Textures, m_MemoryBytes);
+}
+
 Texture::~Texture()
 {
+	Renderer::getInstance().OnTextureDeleted(m_RendererID);
 	GLCall(glDeleteTextures(1, &m_RendererID));
+	GpuMemory::Add(GpuMemory::Category::Textures, -m_MemoryBytes);
 }
 
 void Texture::Bind(unsigned int slot)const
 {
-	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	Renderer::getInstance().BindTexture(slot, m_RendererID);
 }
 
 void Texture::Unbind()const
 {
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	Renderer::getInstance().BindTexture(0, 0);
+}
+
+void Texture::SetSubImage(int x, int y, int width, int height, const void* pixels)
+{
+	Renderer::getInstance().BindTexture(0, m_RendererID);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+}
+
+void Texture::GenerateMipmaps()
+{
+	Renderer::getInstance().BindTexture(0, m_RendererID);
+	GLCall(glGenerateMipmap(GL_TEXTURE_2D));
 }
\ No newline at end of file
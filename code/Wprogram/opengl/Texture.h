@@ -8,13 +8,26 @@ private:
 	std::string m_FilePath;
 	unsigned char* m_LocalBuffer;
 	int m_Width, m_Height, m_BPP;
+	// Reported to GpuMemory, released again in the destructor
+	long long m_MemoryBytes;
 public:
 	Texture(const std::string& path);
+	// Empty RGBA8 texture to be filled with SetSubImage, with a full mip chain when mipmaps is set
+	Texture(int width, int height, bool mipmaps);
 	~Texture();
 
+	Texture(const Texture&) = delete;
+	Texture& operator=(const Texture&) = delete;
+
+	// pixels is an offset into the bound GL_PIXEL_UNPACK_BUFFER when one is bound
+	void SetSubImage(int x, int y, int width, int height, const void* pixels);
+	void GenerateMipmaps();
+
 	void Bind(unsigned int slot = 0)const;
 	void Unbind() const;
 
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
+	inline long long GetMemoryBytes() const { return m_MemoryBytes; }
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "TextureBuffer.h"
+#include "Renderer.h"
+#include "GpuMemory.h"
+
+TextureBuffer::TextureBuffer()
+    :m_Size(0)
+{
+    GLCall(glGenBuffers(1, &m_BufferID));
+    Renderer::getInstance().BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW));
+
+    GLCall(glGenTextures(1, &m_TextureID));
+    Renderer::getInstance().BindTexture(0, m_TextureID, GL_TEXTURE_BUFFER);
+    GLCall(glTexBuffer(GL_TEXTURE_BUFFER, GL_R8, m_BufferID));
+}
+
+TextureBuffer::~TextureBuffer()
+{
+    Renderer::getInstance().OnTextureDeleted(m_TextureID);
+    GLCall(glDeleteTextures(1, &m_TextureID));
+    Renderer::getInstance().OnBufferDeleted(m_BufferID);
+    GLCall(glDeleteBuffers(1, &m_BufferID));
+    GpuMemory::Add(GpuMemory::Category::Buffers, -(long long)m_Size);
+}
+
+void TextureBuffer::Allocate(const void* data, unsigned int size)
+{
+    // The texture keeps referring to the same buffer name, so it does not need re-attaching
+    Renderer::getInstance().BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW));
+    GpuMemory::Add(GpuMemory::Category::Buffers, (long long)size - m_Size);
+    m_Size = size;
+}
+
+void TextureBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    Renderer::getInstance().BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferSubData(GL_TEXTURE_BUFFER, offset, size, data));
+}
+
+void TextureBuffer::Bind(unsigned int slot) const
+{
+    Renderer::getInstance().BindTexture(slot, m_TextureID, GL_TEXTURE_BUFFER);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// One byte per element, read in shaders through a samplerBuffer with texelFetch.
+// Used for per-instance data that changes independently of the instance buffers.
+class TextureBuffer
+{
+private:
+	unsigned int m_BufferID;
+	unsigned int m_TextureID;
+	unsigned int m_Size;
+public:
+	TextureBuffer();
+	~TextureBuffer();
+
+	TextureBuffer(const TextureBuffer&) = delete;
+	TextureBuffer& operator=(const TextureBuffer&) = delete;
+
+	// Reallocates to size bytes initialized from data, which may be null
+	void Allocate(const void* data, unsigned int size);
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+	void Bind(unsigned int slot) const;
+
+	inline unsigned int GetSize() const { return m_Size; }
+};
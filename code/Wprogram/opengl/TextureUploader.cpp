@@ -0,0 +1,44 @@
+#include "TextureUploader.h"
+#include <cstring>
+
+TextureUploader::TextureUploader()
+    :m_NextBuffer(0)
+{
+    GLCall(glGenBuffers(BUFFER_COUNT, m_Buffers));
+}
+
+TextureUploader::~TextureUploader()
+{
+    for (unsigned int i = 0; i < BUFFER_COUNT; i++)
+        Renderer::getInstance().OnBufferDeleted(m_Buffers[i]);
+    GLCall(glDeleteBuffers(BUFFER_COUNT, m_Buffers));
+}
+
+void TextureUploader::Upload(Texture& texture, int x, int y, int width, int height, const unsigned char* pixels, unsigned int stride)
+{
+    unsigned int rowSize = width * 4;
+    unsigned int size = rowSize * height;
+
+    unsigned int buffer = m_Buffers[m_NextBuffer];
+    m_NextBuffer = (m_NextBuffer + 1) % BUFFER_COUNT;
+
+    // Orphaning gives fresh storage, so the previous upload from this buffer never has to finish first
+    Renderer::getInstance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+    void* staging;
+    GLCall(staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (staging)
+    {
+        unsigned char* destination = static_cast<unsigned char*>(staging);
+        for (int row = 0; row < height; row++)
+            memcpy(destination + row * rowSize, pixels + row * stride, rowSize);
+        GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+        texture.SetSubImage(x, y, width, height, (const void*)0);
+    }
+
+    // Anything else uploading textures (ImGui) expects client memory pointers
+    Renderer::getInstance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
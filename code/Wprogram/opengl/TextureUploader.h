@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Texture.h"
+
+// Streams pixel rectangles into textures through pixel unpack buffers, so the
+// driver can copy from the staging buffer asynchronously instead of from client memory.
+class TextureUploader
+{
+private:
+	static constexpr unsigned int BUFFER_COUNT = 2;
+
+	unsigned int m_Buffers[BUFFER_COUNT];
+	unsigned int m_NextBuffer;
+public:
+	TextureUploader();
+	~TextureUploader();
+
+	TextureUploader(const TextureUploader&) = delete;
+	TextureUploader& operator=(const TextureUploader&) = delete;
+
+	// Copies a width x height RGBA8 rectangle whose rows are stride bytes apart to x, y in the texture
+	void Upload(Texture& texture, int x, int y, int width, int height, const unsigned char* pixels, unsigned int stride);
+};
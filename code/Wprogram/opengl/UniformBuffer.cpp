@@ -0,0 +1,36 @@
+#include "UniformBuffer.h"
+#include "Renderer.h"
+#include "GpuMemory.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int binding)
+    :m_Size(size), m_Binding(binding)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    Renderer::getInstance().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+    Renderer::getInstance().BindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+    GpuMemory::Add(GpuMemory::Category::Buffers, m_Size);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    Renderer::getInstance().OnBufferDeleted(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Add(GpuMemory::Category::Buffers, -(long long)m_Size);
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    Renderer::getInstance().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::Bind() const
+{
+    Renderer::getInstance().BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+}
+
+void UniformBuffer::Unbind() const
+{
+    Renderer::getInstance().BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, 0);
+}
@@ -3,13 +3,16 @@
 #include "Renderer.h"
 
 VertexArray::VertexArray()
+	:m_AttributeCount(0), m_InstanceBuffer(nullptr), m_InstanceLayout(nullptr), m_FirstInstanceAttribute(0), m_InstanceBase(0)
 {
 	GLCall(glGenVertexArrays(1, &m_RendererID));
 }
 
 VertexArray::~VertexArray()
 {
+	Renderer::getInstance().OnVertexArrayDeleted(m_RendererID);
 	GLCall(glDeleteVertexArrays(1, &m_RendererID));
+	delete m_InstanceLayout;
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
@@ -25,14 +28,57 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
 	GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
 	offset += element.count*VertexBufferElement::GetSizeOfType(element.type);
 	}
+	m_AttributeCount = elements.size();
+}
+
+void VertexArray::AddInstanceBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+{
+	delete m_InstanceLayout;
+	m_InstanceLayout = new VertexBufferLayout(layout);
+	m_InstanceBuffer = &vb;
+	m_FirstInstanceAttribute = m_AttributeCount;
+	m_InstanceBase = 0;
+
+	Bind();
+	vb.Bind();
+	const auto& elements = layout.GetElements();
+	for (unsigned int i = 0; i < elements.size(); i++)
+	{
+		GLCall(glEnableVertexAttribArray(m_FirstInstanceAttribute + i));
+		GLCall(glVertexAttribDivisor(m_FirstInstanceAttribute + i, 1));
+	}
+	SetAttributePointers(layout, m_FirstInstanceAttribute, 0);
+}
+
+void VertexArray::SetInstanceBase(unsigned int firstInstance) const
+{
+	if (m_InstanceLayout == nullptr || firstInstance == m_InstanceBase)
+		return;
+
+	Bind();
+	m_InstanceBuffer->Bind();
+	SetAttributePointers(*m_InstanceLayout, m_FirstInstanceAttribute, firstInstance * m_InstanceLayout->GetStride());
+	m_InstanceBase = firstInstance;
+}
+
+void VertexArray::SetAttributePointers(const VertexBufferLayout& layout, unsigned int firstAttribute, unsigned int baseOffset) const
+{
+	const auto& elements = layout.GetElements();
+	unsigned int offset = baseOffset;
+	for (unsigned int i = 0; i < elements.size(); i++)
+	{
+		const auto& element = elements[i];
+		GLCall(glVertexAttribPointer(firstAttribute + i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)(size_t)offset));
+		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+	}
 }
 
 void VertexArray::Bind()const
 {
-	GLCall(glBindVertexArray(m_RendererID));
+	Renderer::getInstance().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind()const
 {
-	GLCall(glBindVertexArray(0));
+	Renderer::getInstance().BindVertexArray(0);
 }
\ No newline at end of file
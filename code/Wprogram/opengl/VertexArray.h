@@ -6,11 +6,30 @@ class VertexBufferLayout;
 class VertexArray {
 private:
 	unsigned int m_RendererID;
+	unsigned int m_AttributeCount;
+
+	// Per-instance attributes, re-pointed by SetInstanceBase
+	const VertexBuffer* m_InstanceBuffer;
+	VertexBufferLayout* m_InstanceLayout;
+	unsigned int m_FirstInstanceAttribute;
+	mutable unsigned int m_InstanceBase;
+
+	void SetAttributePointers(const VertexBufferLayout& layout, unsigned int firstAttribute, unsigned int baseOffset) const;
 public:
 	VertexArray();
 	~VertexArray();
 
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
+
 	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	// Attributes follow the ones added by AddBuffer and advance once per instance
+	void AddInstanceBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+
+	// GL 3.3 has no base instance, so instanced draws starting past instance 0 offset the attribute pointers instead
+	void SetInstanceBase(unsigned int firstInstance) const;
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 
 	void Bind() const;
 	void Unbind() const;
@@ -1,25 +1,91 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
+#include "GpuMemory.h"
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, BufferUsage usage)
+    :m_Size(data ? size : 0), m_Capacity(size), m_Usage(usage)
 {
     GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
-
+    Renderer::getInstance().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GetGLBufferUsage(usage)));
+    GpuMemory::Add(GpuMemory::Category::Buffers, (long long)m_Capacity);
 }
 
 VertexBuffer::~VertexBuffer()
 {
+    Renderer::getInstance().OnBufferDeleted(m_RendererID);
     GLCall(glDeleteBuffers(1, &m_RendererID));
+    GpuMemory::Add(GpuMemory::Category::Buffers, -(long long)m_Capacity);
 }
 
 void VertexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    Renderer::getInstance().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
 void VertexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+    Renderer::getInstance().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    if (size == 0) return;
+
+    Bind();
+    if (offset == 0 && size >= m_Size)
+    {
+        // Replacing everything: orphan the old storage instead of waiting for draws that still use it
+        unsigned int oldCapacity = m_Capacity;
+        m_Capacity = size > m_Capacity ? GrowBufferCapacity(m_Capacity, size) : m_Capacity;
+        GLCall(glBufferData(GL_ARRAY_BUFFER, m_Capacity, nullptr, GetGLBufferUsage(m_Usage)));
+        GpuMemory::Add(GpuMemory::Category::Buffers, (long long)m_Capacity - oldCapacity);
+    }
+    else if (offset + size > m_Capacity)
+    {
+        Reserve(offset + size);
+        Bind();
+    }
+
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+    m_Size = offset + size > m_Size ? offset + size : m_Size;
+}
+
+void VertexBuffer::Reserve(unsigned int capacity)
+{
+    if (capacity <= m_Capacity) return;
+
+    unsigned int oldCapacity = m_Capacity;
+    m_Capacity = GrowBufferCapacity(m_Capacity, capacity);
+    ReallocateBuffer(m_RendererID, m_Size, m_Capacity, m_Usage);
+    GpuMemory::Add(GpuMemory::Category::Buffers, (long long)m_Capacity - oldCapacity);
+}
+
+void* VertexBuffer::Map(unsigned int offset, unsigned int size, bool unsynchronized)
+{
+    if (offset + size > m_Capacity)
+        Reserve(offset + size);
+
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    if (unsynchronized)
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+
+    Bind();
+    void* pointer;
+    GLCall(pointer = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, access));
+    if (pointer)
+        m_Size = offset + size > m_Size ? offset + size : m_Size;
+    return pointer;
+}
+
+void VertexBuffer::Flush(unsigned int offset, unsigned int size)
+{
+    Bind();
+    GLCall(glFlushMappedBufferRange(GL_ARRAY_BUFFER, offset, size));
+}
+
+void VertexBuffer::Unmap()
+{
+    Bind();
+    GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+}
@@ -1,13 +1,40 @@
 #pragma once
 
+#include "GLBuffer.h"
+
 class VertexBuffer
 {
 private:
 	unsigned int m_RendererID;
+	unsigned int m_Size;
+	unsigned int m_Capacity;
+	BufferUsage m_Usage;
 public:
-	VertexBuffer(const void* data, unsigned int size);
+	// data may be null to only allocate size bytes
+	VertexBuffer(const void* data, unsigned int size, BufferUsage usage = BufferUsage::Static);
 	~VertexBuffer();
 
+	VertexBuffer(const VertexBuffer&) = delete;
+	VertexBuffer& operator=(const VertexBuffer&) = delete;
+
 	void Bind() const;
 	void Unbind() const;
-};
\ No newline at end of file
+
+	// Writes size bytes at offset, growing the buffer when the range does not fit
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+	// Grows to at least capacity bytes, keeping the current contents
+	void Reserve(unsigned int capacity);
+
+	// Maps a range for writing, nothing is visible to the GPU until it is flushed.
+	// unsynchronized skips the implicit wait for draws still reading the buffer.
+	void* Map(unsigned int offset, unsigned int size, bool unsynchronized = false);
+	// offset is relative to the start of the mapped range
+	void Flush(unsigned int offset, unsigned int size);
+	void Unmap();
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	// Bytes written so far, the end of the furthest range that has been set or mapped
+	inline unsigned int GetSize() const { return m_Size; }
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+	inline BufferUsage GetUsage() const { return m_Usage; }
+};
@@ -4,14 +4,47 @@
 layout(location = 0) in vec4 position;
 layout(location = 1) in vec2 texCoord;
 
+// Per instance: center.xy, diameter
+layout(location = 2) in vec3 a_Circle;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in float a_Radius;
+// Per instance: stamp rectangle in the brush atlas (empty for the round brush) and its rotation
+layout(location = 5) in vec4 a_AtlasRect;
+layout(location = 6) in float a_Rotation;
+// Per instance: slot in the erase highlight buffer, negative when the instance has none
+layout(location = 7) in float a_HighlightIndex;
+
 out vec2 v_TexCoord;
+out vec2 v_StampCoord;
+flat out vec4 v_Color;
+flat out float v_Radius;
+flat out vec4 v_AtlasRect;
+
+// One byte per committed instance, set while the eraser is over it
+uniform samplerBuffer u_Highlight;
 
-uniform mat4 u_MVP;
+// Uploaded once per frame
+layout(std140) uniform FrameConstants
+{
+   mat4 u_ViewProjection;
+   vec4 u_Viewport;
+};
 
 void main()
 {
-   gl_Position= u_MVP * position;
+   vec4 worldPosition = vec4(position.xy * a_Circle.z + a_Circle.xy, position.zw);
+   gl_Position = u_ViewProjection * worldPosition;
    v_TexCoord=texCoord;
+   float highlighted = a_HighlightIndex >= 0.0 ? texelFetch(u_Highlight, int(a_HighlightIndex)).r : 0.0;
+   v_Color = vec4(a_Color.rgb, a_Color.a * mix(1.0, 0.3, highlighted));
+   v_Radius = a_Radius;
+   v_AtlasRect = a_AtlasRect;
+
+   // Stamps cover the same footprint as the round brush, turned around the quad center
+   float c = cos(a_Rotation);
+   float s = sin(a_Rotation);
+   vec2 offset = (texCoord - vec2(0.5)) * (0.5 / a_Radius);
+   v_StampCoord = vec2(c * offset.x + s * offset.y, -s * offset.x + c * offset.y) + vec2(0.5);
 };
 
 #shader fragment
@@ -20,19 +53,34 @@ void main()
 layout(location = 0) out vec4 color;
 
 in vec2 v_TexCoord;
+in vec2 v_StampCoord;
+flat in vec4 v_Color;
+flat in float v_Radius;
+flat in vec4 v_AtlasRect;
 
-uniform vec4 u_color;
 uniform vec2 circleCenter;
-uniform float circleRadius;
+uniform sampler2D u_Atlas;
 
 void main()
 {
+   if (v_AtlasRect.z > v_AtlasRect.x)
+   {
+       //textured stamp, the mask is in alpha
+       if (any(lessThan(v_StampCoord, vec2(0.0))) || any(greaterThan(v_StampCoord, vec2(1.0))))
+           discard;
+       float coverage = texture(u_Atlas, mix(v_AtlasRect.xy, v_AtlasRect.zw, v_StampCoord)).a;
+       if (coverage <= 0.0)
+           discard;
+       color = vec4(v_Color.rgb, v_Color.a * coverage);
+       return;
+   }
+
    //make circle
     
    float dist = distance(v_TexCoord, circleCenter);
-   if (dist < circleRadius)
-       color=u_color;
+   if (dist < v_Radius)
+       color=v_Color;
    else
        discard;
    
-};
\ No newline at end of file
+};
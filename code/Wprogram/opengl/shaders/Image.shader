@@ -0,0 +1,39 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+// Per instance: center.xy, size.xy in world units, and the uv rectangle u0, v0, u1, v1
+layout(location = 2) in vec4 a_Rect;
+layout(location = 3) in vec4 a_UV;
+
+out vec2 v_TexCoord;
+
+// Uploaded once per frame
+layout(std140) uniform FrameConstants
+{
+   mat4 u_ViewProjection;
+   vec4 u_Viewport;
+};
+
+void main()
+{
+   vec4 worldPosition = vec4(position.xy * a_Rect.zw + a_Rect.xy, position.zw);
+   gl_Position = u_ViewProjection * worldPosition;
+   v_TexCoord = mix(a_UV.xy, a_UV.zw, texCoord);
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+   color = texture(u_Texture, v_TexCoord);
+};